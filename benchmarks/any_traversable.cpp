@@ -0,0 +1,90 @@
+#include <any_traversable.hpp>
+#include <traverse.hpp>
+
+#include "./benchmark.hpp"
+
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+// Cost of the type erasure of dpsg::any_traversable compared to the fully
+// templated traversal of the same objects. Usage: any_traversable [size]
+
+using handle = dpsg::any_traversable<const std::uint64_t&>;
+
+template <class T>
+BENCH_NOINLINE std::uint64_t templated_sum(const T& values) {
+  std::uint64_t sum = 0;
+  dpsg::traverse(values, [&sum](std::uint64_t v) { sum += v; });
+  return sum;
+}
+
+BENCH_NOINLINE std::uint64_t erased_sum(const handle& values) {
+  std::uint64_t sum = 0;
+  dpsg::traverse(values, [&sum](std::uint64_t v) { sum += v; });
+  return sum;
+}
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 1 << 22);
+
+  std::vector<std::uint64_t> vector(size);
+  std::iota(vector.begin(), vector.end(), std::uint64_t{0});
+  const handle erased_vector{vector};
+
+  using tuple = std::tuple<std::uint64_t,
+                           std::uint32_t,
+                           std::uint16_t,
+                           std::uint8_t,
+                           std::uint64_t,
+                           std::uint32_t,
+                           std::uint16_t,
+                           std::uint8_t>;
+  const tuple small{1, 2, 3, 4, 5, 6, 7, 8};
+  const handle erased_small{small};
+  const std::size_t iterations = size / 8;
+  const std::array<std::uint64_t, 16> large{};
+  static_assert(handle::stores_inline<tuple>);
+  static_assert(!handle::stores_inline<decltype(large)>);
+
+  std::cout << size << " elements\n";
+  {
+    bench::table t{"std::vector<u64>"};
+    t.measure("dpsg::traverse",
+              [&] { bench::do_not_optimize(templated_sum(vector)); });
+    t.measure("dpsg::traverse(any_traversable)",
+              [&] { bench::do_not_optimize(erased_sum(erased_vector)); });
+  }
+  {
+    bench::table t{"std::tuple of 8 integers, repeatedly"};
+    t.measure("dpsg::traverse", [&] {
+      for (std::size_t i = 0; i < iterations; ++i) {
+        bench::do_not_optimize(templated_sum(small));
+      }
+    });
+    t.measure("dpsg::traverse(any_traversable)", [&] {
+      for (std::size_t i = 0; i < iterations; ++i) {
+        bench::do_not_optimize(erased_sum(erased_small));
+      }
+    });
+  }
+  {
+    bench::table t{"Construction and destruction of the handle"};
+    t.measure("small tuple (inline storage)", [&] {
+      for (std::size_t i = 0; i < iterations; ++i) {
+        handle h{small};
+        bench::do_not_optimize(h);
+      }
+    });
+    t.measure("std::array<u64, 16> (heap storage)", [&] {
+      for (std::size_t i = 0; i < iterations; ++i) {
+        handle h{large};
+        bench::do_not_optimize(h);
+      }
+    });
+  }
+
+  return 0;
+}
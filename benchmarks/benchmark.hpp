@@ -0,0 +1,103 @@
+#ifndef GUARD_DPSG_BENCHMARK_HPP
+#define GUARD_DPSG_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal timing utilities shared by the benchmarks. Every measure is run
+// several times and the median is reported, along with its ratio to the first
+// measure of the same table so that results read as "x times the baseline".
+
+// Stands in for a library boundary in the benchmarks
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace bench {
+
+// Prevents the compiler from optimizing away a value we computed
+template <class T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const T* sink;
+  sink = &value;
+#endif
+}
+
+// Reads the n-th command line argument as a size, or returns a default
+inline std::size_t arg_or(int argc,
+                          char** argv,
+                          int n,
+                          std::size_t default_value) {
+  if (argc > n) {
+    return static_cast<std::size_t>(std::strtoull(argv[n], nullptr, 10));
+  }
+  return default_value;
+}
+
+// Evicts the caches by walking a buffer larger than the last level cache
+inline void flush_caches() {
+  static std::vector<char> buffer(std::size_t{64} << 20);
+  for (std::size_t i = 0; i < buffer.size(); i += 64) {
+    buffer[i] = static_cast<char>(buffer[i] + 1);
+  }
+  do_not_optimize(buffer.data());
+}
+
+class table {
+ public:
+  explicit table(std::string title, std::size_t repetitions = 5)
+      : repetitions_{repetitions} {
+    std::cout << "\n"
+              << title << "\n"
+              << std::string(title.size(), '=') << "\n";
+  }
+
+  // Runs setup (untimed) then f (timed) `repetitions` times
+  template <class Setup, class F>
+  double measure(const std::string& name, Setup&& setup, F&& f) {
+    std::vector<double> times;
+    times.reserve(repetitions_);
+    for (std::size_t i = 0; i < repetitions_; ++i) {
+      setup();
+      auto start = std::chrono::steady_clock::now();
+      f();
+      auto stop = std::chrono::steady_clock::now();
+      times.push_back(
+          std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    double median = times[times.size() / 2];
+    if (baseline_ <= 0) {
+      baseline_ = median;
+    }
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(3) << median
+              << " ms" << std::setw(10) << std::setprecision(2)
+              << median / baseline_ << "x\n";
+    return median;
+  }
+
+  template <class F>
+  double measure(const std::string& name, F&& f) {
+    return measure(name, [] {}, std::forward<F>(f));
+  }
+
+ private:
+  std::size_t repetitions_;
+  double baseline_{0};
+};
+
+}  // namespace bench
+
+#endif  // GUARD_DPSG_BENCHMARK_HPP
@@ -0,0 +1,107 @@
+#include <by_alternative.hpp>
+#include <fold.hpp>
+
+#include "./benchmark.hpp"
+
+#include <random>
+#include <variant>
+#include <vector>
+
+// Total area of a stream of shapes whose kinds are mixed at random: a
+// std::visit per element (dpsg::fold), dispatch per run of equal
+// alternatives, a prebuilt alternative_index and a range sorted by
+// alternative. Usage: by_alternative [elements]
+
+namespace {
+struct circle {
+  float radius;
+};
+struct square {
+  float side;
+};
+struct triangle {
+  float base;
+  float height;
+};
+using shape = std::variant<circle, square, triangle>;
+
+struct area {
+  float operator()(float acc, const circle& c) const {
+    return acc + 3.14159f * c.radius * c.radius;
+  }
+  float operator()(float acc, const square& s) const {
+    return acc + s.side * s.side;
+  }
+  float operator()(float acc, const triangle& t) const {
+    return acc + 0.5f * t.base * t.height;
+  }
+};
+}  // namespace
+
+BENCH_NOINLINE float visit_each(const std::vector<shape>& shapes) {
+  return dpsg::fold(shapes, 0.f, [](float acc, const shape& s) {
+    return dpsg::fold(s, acc, area{});
+  });
+}
+
+BENCH_NOINLINE float by_runs(const std::vector<shape>& shapes) {
+  return dpsg::fold_by_alternative(shapes, 0.f, area{});
+}
+
+BENCH_NOINLINE float with_index(
+    const dpsg::alternative_index<shape>& index,
+    const std::vector<shape>& shapes) {
+  return index.fold(shapes, 0.f, area{});
+}
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 1 << 22);
+
+  std::mt19937 random{42};
+  std::uniform_int_distribution<int> kind{0, 2};
+  std::uniform_real_distribution<float> length{0.5f, 2.f};
+  std::vector<shape> shapes;
+  shapes.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    switch (kind(random)) {
+      case 0:
+        shapes.emplace_back(circle{length(random)});
+        break;
+      case 1:
+        shapes.emplace_back(square{length(random)});
+        break;
+      default:
+        shapes.emplace_back(triangle{length(random), length(random)});
+    }
+  }
+  dpsg::alternative_index<shape> index{shapes};
+  std::vector<shape> sorted = shapes;
+  dpsg::sort_by_alternative(sorted);
+
+  std::cout << size << " shapes in random order\n";
+  bench::table t{"Sum of the areas"};
+  t.measure("dpsg::fold, std::visit per element",
+            [&] { bench::do_not_optimize(visit_each(shapes)); });
+  t.measure("fold_by_alternative, random order",
+            [&] { bench::do_not_optimize(by_runs(shapes)); });
+  t.measure("alternative_index::fold, prebuilt",
+            [&] { bench::do_not_optimize(with_index(index, shapes)); });
+  t.measure("fold_by_alternative, sorted range",
+            [&] { bench::do_not_optimize(by_runs(sorted)); });
+  t.measure("dpsg::fold, sorted range",
+            [&] { bench::do_not_optimize(visit_each(sorted)); });
+
+  bench::table setup{"One-time costs"};
+  setup.measure("building the alternative_index", [&] {
+    index.assign(shapes);
+    bench::do_not_optimize(index.size());
+  });
+  setup.measure(
+      "sort_by_alternative",
+      [&] { sorted = shapes; },
+      [&] {
+        dpsg::sort_by_alternative(sorted);
+        bench::do_not_optimize(sorted.size());
+      });
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <traverse.hpp>
+
+#include "./benchmark.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Traversal of large heterogeneous tuples, fully unrolled or through indexed
+// dispatch. Several tuple types are traversed in turn so that the unrolled
+// code competes for the instruction cache, as it would in a larger hot loop.
+// Usage: dispatch [iterations]
+
+template <std::size_t Seed, std::size_t I>
+using element_t = std::conditional_t<
+    (I * 7 + Seed) % 4 == 0,
+    std::int32_t,
+    std::conditional_t<(I * 7 + Seed) % 4 == 1,
+                       std::int64_t,
+                       std::conditional_t<(I * 7 + Seed) % 4 == 2,
+                                          float,
+                                          double>>>;
+
+// Value-initialized, constructing the elements from values is much slower
+// to compile
+template <std::size_t Seed, std::size_t... Is>
+auto make_tuple_of([[maybe_unused]] std::index_sequence<Is...> marker) {
+  return std::tuple<element_t<Seed, Is>...>{};
+}
+
+constexpr std::size_t elements = 128;
+
+template <std::size_t Seed>
+auto tuple_of = make_tuple_of<Seed>(std::make_index_sequence<elements>{});
+
+template <std::size_t... Seeds>
+void fill([[maybe_unused]] std::index_sequence<Seeds...> marker) {
+  int i = 0;
+  (dpsg::traverse(tuple_of<Seeds>,
+                  [&i](auto& element) {
+                    element = static_cast<std::decay_t<decltype(element)>>(
+                        i++ % 10);
+                  }),
+   ...);
+}
+
+struct accumulate {
+  double* result;
+  template <class T>
+  void operator()(T value) const {
+    *result = *result * 0.5 + static_cast<double>(value);
+  }
+};
+
+template <class Policy, std::size_t... Seeds>
+BENCH_NOINLINE double traverse_all(
+    [[maybe_unused]] std::index_sequence<Seeds...> marker) {
+  double result = 0;
+  (dpsg::traverse(dpsg::with_policy(Policy{}, tuple_of<Seeds>),
+                  accumulate{&result}),
+   ...);
+  return result;
+}
+
+template <class Policy, std::size_t Types>
+void measure(bench::table& t, const char* name, std::size_t iterations) {
+  t.measure(name, [&] {
+    for (std::size_t i = 0; i < iterations; ++i) {
+      bench::do_not_optimize(
+          traverse_all<Policy>(std::make_index_sequence<Types>{}));
+    }
+  });
+}
+
+int main(int argc, char** argv) {
+  const std::size_t iterations = bench::arg_or(argc, argv, 1, 20'000);
+
+  fill(std::make_index_sequence<4>{});
+
+  std::cout << elements << " elements per tuple, 4 distinct types\n";
+  {
+    bench::table t{"1 tuple type"};
+    measure<decltype(dpsg::always_unroll), 1>(t, "unrolled", iterations);
+    measure<decltype(dpsg::never_unroll), 1>(t, "indexed dispatch", iterations);
+  }
+  {
+    bench::table t{"4 tuple types"};
+    measure<decltype(dpsg::always_unroll), 4>(t, "unrolled", iterations / 4);
+    measure<decltype(dpsg::never_unroll), 4>(
+        t, "indexed dispatch", iterations / 4);
+  }
+  return 0;
+}
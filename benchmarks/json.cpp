@@ -0,0 +1,248 @@
+#include <json.hpp>
+
+#include "./benchmark.hpp"
+
+#include <array>
+#include <charconv>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// Round trip of a vector of records through dpsg::json, compared to the same
+// round trip through a small DOM in the style of the general purpose JSON
+// libraries: every value becomes a node, objects are maps, and the records
+// are converted to and from the DOM. Usage: json [records]
+
+struct record {
+  int id;
+  std::string name;
+  double score;
+  std::vector<int> tags;
+  std::optional<std::string> note;
+
+  template <
+      class Self,
+      class F,
+      std::enable_if_t<std::is_same_v<std::decay_t<Self>, record>, int> = 0>
+  friend void dpsg_traverse(Self& r, F&& f) {
+    f(r.id);
+    f(r.name);
+    f(r.score);
+    f(r.tags);
+    f(r.note);
+  }
+};
+constexpr std::array<std::string_view, 5> dpsg_json_fields(const record&) {
+  return {"id", "name", "score", "tags", "note"};
+}
+
+namespace dom {
+struct value;
+using array = std::vector<value>;
+using object = std::map<std::string, value, std::less<>>;
+struct value {
+  std::variant<std::nullptr_t, bool, double, std::string, array, object> v;
+};
+
+void write(const value& v, std::string& out) {
+  std::visit(
+      [&out](const auto& x) {
+        using T = std::decay_t<decltype(x)>;
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+          out += "null";
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+          out += x ? "true" : "false";
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+          char buffer[32];
+          auto [end, ec] = std::to_chars(buffer, buffer + 32, x);
+          out.append(buffer, end);
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+          // The benchmark strings don't need escaping
+          out += '"';
+          out += x;
+          out += '"';
+        }
+        else if constexpr (std::is_same_v<T, array>) {
+          out += '[';
+          for (std::size_t i = 0; i < x.size(); ++i) {
+            if (i != 0) {
+              out += ',';
+            }
+            write(x[i], out);
+          }
+          out += ']';
+        }
+        else {
+          out += '{';
+          bool first = true;
+          for (const auto& [key, element] : x) {
+            if (!first) {
+              out += ',';
+            }
+            first = false;
+            out += '"';
+            out += key;
+            out += "\":";
+            write(element, out);
+          }
+          out += '}';
+        }
+      },
+      v.v);
+}
+
+struct parser {
+  const char* current;
+
+  value parse() {
+    switch (*current) {
+      case 'n':
+        current += 4;
+        return {nullptr};
+      case 't':
+        current += 4;
+        return {true};
+      case 'f':
+        current += 5;
+        return {false};
+      case '"':
+        return {string()};
+      case '[': {
+        ++current;
+        array a;
+        while (*current != ']') {
+          a.push_back(parse());
+          if (*current == ',') {
+            ++current;
+          }
+        }
+        ++current;
+        return {std::move(a)};
+      }
+      case '{': {
+        ++current;
+        object o;
+        while (*current != '}') {
+          std::string key = string();
+          ++current;  // ':'
+          o.emplace(std::move(key), parse());
+          if (*current == ',') {
+            ++current;
+          }
+        }
+        ++current;
+        return {std::move(o)};
+      }
+      default: {
+        double d{};
+        current = std::from_chars(current, current + 32, d).ptr;
+        return {d};
+      }
+    }
+  }
+
+  std::string string() {
+    const char* begin = ++current;
+    while (*current != '"') {
+      ++current;
+    }
+    return std::string{begin, current++};
+  }
+};
+
+value from(const record& r) {
+  array tags;
+  for (int tag : r.tags) {
+    tags.push_back({static_cast<double>(tag)});
+  }
+  object o;
+  o.emplace("id", value{static_cast<double>(r.id)});
+  o.emplace("name", value{r.name});
+  o.emplace("score", value{r.score});
+  o.emplace("tags", value{std::move(tags)});
+  o.emplace("note", r.note ? value{*r.note} : value{nullptr});
+  return {std::move(o)};
+}
+
+record to_record(const value& v) {
+  const auto& o = std::get<object>(v.v);
+  record r{};
+  r.id = static_cast<int>(std::get<double>(o.find("id")->second.v));
+  r.name = std::get<std::string>(o.find("name")->second.v);
+  r.score = std::get<double>(o.find("score")->second.v);
+  for (const auto& tag : std::get<array>(o.find("tags")->second.v)) {
+    r.tags.push_back(static_cast<int>(std::get<double>(tag.v)));
+  }
+  const auto& note = o.find("note")->second.v;
+  if (const auto* s = std::get_if<std::string>(&note)) {
+    r.note = *s;
+  }
+  return r;
+}
+}  // namespace dom
+
+BENCH_NOINLINE std::size_t dom_round_trip(const std::vector<record>& records,
+                                          std::vector<record>& result) {
+  dom::array document;
+  for (const auto& r : records) {
+    document.push_back(dom::from(r));
+  }
+  std::string text;
+  dom::write({std::move(document)}, text);
+
+  dom::parser parser{text.c_str()};
+  const dom::value parsed = parser.parse();
+  result.clear();
+  for (const auto& v : std::get<dom::array>(parsed.v)) {
+    result.push_back(dom::to_record(v));
+  }
+  return text.size();
+}
+
+BENCH_NOINLINE std::size_t streaming_round_trip(
+    const std::vector<record>& records,
+    std::vector<record>& result,
+    std::vector<char>& buffer) {
+  auto written =
+      dpsg::json::write(buffer.data(), buffer.data() + buffer.size(), records);
+  dpsg::json::read(buffer.data(), written.ptr, result);
+  return static_cast<std::size_t>(written.ptr - buffer.data());
+}
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 10'000);
+
+  std::vector<record> records;
+  for (std::size_t i = 0; i < size; ++i) {
+    const int n = static_cast<int>(i);
+    records.push_back(record{n,
+                             "record number " + std::to_string(i),
+                             n * 0.5,
+                             {n, n + 1, n + 2},
+                             i % 2 == 0 ? std::optional<std::string>{"even"}
+                                        : std::nullopt});
+  }
+  std::vector<char> buffer(size * 128);
+  std::vector<record> result;
+
+  std::cout << size << " records\n";
+  bench::table t{"Round trip through JSON"};
+  t.measure("DOM", [&] {
+    bench::do_not_optimize(dom_round_trip(records, result));
+  });
+  t.measure("dpsg::json, reusing the result", [&] {
+    bench::do_not_optimize(streaming_round_trip(records, result, buffer));
+  });
+  t.measure("dpsg::json, into a fresh vector", [&] {
+    std::vector<record> fresh;
+    bench::do_not_optimize(streaming_round_trip(records, fresh, buffer));
+  });
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include <fold.hpp>
+#include <multi_fold.hpp>
+
+#include "./benchmark.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Count, sum, minimum and maximum of a large vector of floats: four calls to
+// dpsg::fold against a single multi_fold, with reductions folded in order
+// and with splittable reductions spread over independent lanes.
+// Usage: multi_fold [elements]
+
+namespace {
+using stats = std::tuple<std::size_t, float, float, float>;
+
+constexpr float infinity = std::numeric_limits<float>::infinity();
+
+constexpr auto count = [](std::size_t acc, float) { return acc + 1; };
+constexpr auto add = [](float acc, float f) { return acc + f; };
+constexpr auto keep_min = [](float acc, float f) { return f < acc ? f : acc; };
+constexpr auto keep_max = [](float acc, float f) { return acc < f ? f : acc; };
+}  // namespace
+
+BENCH_NOINLINE stats separate_folds(const std::vector<float>& v) {
+  return {dpsg::fold(v, std::size_t{0}, count),
+          dpsg::fold(v, 0.f, add),
+          dpsg::fold(v, infinity, keep_min),
+          dpsg::fold(v, -infinity, keep_max)};
+}
+
+BENCH_NOINLINE stats in_order(const std::vector<float>& v) {
+  return dpsg::multi_fold(v,
+                          dpsg::reduce(std::size_t{0}, count),
+                          dpsg::reduce(0.f, add),
+                          dpsg::reduce(infinity, keep_min),
+                          dpsg::reduce(-infinity, keep_max));
+}
+
+BENCH_NOINLINE stats split(const std::vector<float>& v) {
+  namespace r = dpsg::reductions;
+  return dpsg::multi_fold(v,
+                          r::count(),
+                          r::sum(0.f),
+                          r::minimum(infinity),
+                          r::maximum(-infinity));
+}
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 1 << 24);
+
+  std::mt19937 random{42};
+  std::vector<float> values(size);
+  for (auto& v : values) {
+    v = std::uniform_real_distribution<float>{-1.f, 1.f}(random);
+  }
+  // Sums may differ in rounding, the other reductions may not
+  const auto expected = separate_folds(values);
+  const auto lanes = split(values);
+  if (in_order(values) != expected ||
+      std::get<0>(lanes) != std::get<0>(expected) ||
+      std::get<2>(lanes) != std::get<2>(expected) ||
+      std::get<3>(lanes) != std::get<3>(expected)) {
+    return 1;
+  }
+
+  std::cout << size << " elements\n";
+  bench::table t{"count, sum, min, max"};
+  t.measure("four dpsg::fold",
+            [&] { bench::do_not_optimize(separate_folds(values)); });
+  t.measure("multi_fold, in order",
+            [&] { bench::do_not_optimize(in_order(values)); });
+  t.measure("multi_fold, lanes",
+            [&] { bench::do_not_optimize(split(values)); });
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <fold.hpp>
+#include <pipeline.hpp>
+#include <traverse.hpp>
+
+#include "./benchmark.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Sum of the squares of the odd elements of a large vector: a fused
+// dpsg pipeline against a hand-fused loop and visitor, and against the
+// same computation staged through intermediate vectors.
+// Usage: pipeline [elements]
+
+namespace {
+constexpr auto is_odd = [](std::int32_t i) { return i % 2 != 0; };
+constexpr auto square = [](std::int32_t i) {
+  return std::int64_t{i} * std::int64_t{i};
+};
+}  // namespace
+
+BENCH_NOINLINE std::int64_t hand_loop(const std::vector<std::int32_t>& v) {
+  std::int64_t sum = 0;
+  for (std::int32_t i : v) {
+    if (is_odd(i)) {
+      sum += square(i);
+    }
+  }
+  return sum;
+}
+
+BENCH_NOINLINE std::int64_t hand_visitor(const std::vector<std::int32_t>& v) {
+  std::int64_t sum = 0;
+  dpsg::traverse(v, [&sum](std::int32_t i) {
+    if (is_odd(i)) {
+      sum += square(i);
+    }
+  });
+  return sum;
+}
+
+BENCH_NOINLINE std::int64_t pipeline_traverse(
+    const std::vector<std::int32_t>& v) {
+  std::int64_t sum = 0;
+  dpsg::traverse(v | dpsg::filter(is_odd) | dpsg::transform(square),
+                 [&sum](std::int64_t i) { sum += i; });
+  return sum;
+}
+
+BENCH_NOINLINE std::int64_t pipeline_fold(const std::vector<std::int32_t>& v) {
+  return dpsg::fold(v | dpsg::filter(is_odd) | dpsg::transform(square),
+                    std::int64_t{0},
+                    std::plus<>{});
+}
+
+BENCH_NOINLINE std::int64_t staged(const std::vector<std::int32_t>& v) {
+  std::vector<std::int32_t> odd;
+  std::copy_if(v.begin(), v.end(), std::back_inserter(odd), is_odd);
+  std::vector<std::int64_t> squares(odd.size());
+  std::transform(odd.begin(), odd.end(), squares.begin(), square);
+  return std::accumulate(squares.begin(), squares.end(), std::int64_t{0});
+}
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 1 << 24);
+
+  std::mt19937 random{42};
+  std::vector<std::int32_t> values(size);
+  for (auto& v : values) {
+    v = std::uniform_int_distribution<std::int32_t>{-100000, 100000}(random);
+  }
+  if (pipeline_fold(values) != hand_loop(values) ||
+      pipeline_traverse(values) != hand_loop(values)) {
+    return 1;
+  }
+
+  std::cout << size << " elements\n";
+  bench::table t{"filter | transform | fold"};
+  t.measure("hand-written loop",
+            [&] { bench::do_not_optimize(hand_loop(values)); });
+  t.measure("hand-fused visitor",
+            [&] { bench::do_not_optimize(hand_visitor(values)); });
+  t.measure("pipeline, traverse",
+            [&] { bench::do_not_optimize(pipeline_traverse(values)); });
+  t.measure("pipeline, fold",
+            [&] { bench::do_not_optimize(pipeline_fold(values)); });
+  t.measure("intermediate vectors",
+            [&] { bench::do_not_optimize(staged(values)); });
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include <fold.hpp>
+#include <prefetch.hpp>
+#include <traverse.hpp>
+
+#include "./benchmark.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Cold cache traversal of node-based containers, with and without software
+// prefetching. Usage: prefetch [element count] [prefetch distance] [work]
+//
+// Prefetching cannot shorten the chain of dependent loads needed to walk the
+// nodes, so a visitor doing nothing gains nothing. What it does is overlap the
+// upcoming misses with the work of the visitor: `work` rounds of integer
+// hashing are performed per element to stand in for that work.
+
+struct payload {
+  std::uint64_t value;
+  char padding[56];
+};
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 1 << 20);
+  const std::size_t distance = bench::arg_or(argc, argv, 2, 16);
+  const std::size_t work = bench::arg_or(argc, argv, 3, 64);
+
+  // Keys are inserted in a random order so that iteration order and
+  // allocation order are unrelated, as they would be in a long lived map
+  std::vector<std::uint64_t> keys(size);
+  std::iota(keys.begin(), keys.end(), std::uint64_t{0});
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64{42});
+
+  std::map<std::uint64_t, std::uint64_t> map;
+  std::map<std::uint64_t, std::unique_ptr<payload>> indirect;
+  for (auto key : keys) {
+    map.emplace(key, key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64{43});
+  for (auto key : keys) {
+    indirect.emplace(key, std::make_unique<payload>(payload{key, {}}));
+  }
+
+  // Build a list whose nodes are scattered the same way
+  std::list<std::uint64_t> list;
+  {
+    std::vector<std::list<std::uint64_t>::iterator> positions;
+    positions.reserve(size);
+    for (auto key : keys) {
+      positions.push_back(list.insert(list.end(), key));
+    }
+    std::list<std::uint64_t> shuffled;
+    std::shuffle(positions.begin(), positions.end(), std::mt19937_64{44});
+    for (auto it : positions) {
+      shuffled.splice(shuffled.end(), list, it);
+    }
+    list.swap(shuffled);
+  }
+
+  const auto sum_map = [](std::uint64_t acc, const auto& kv) {
+    return acc + kv.second;
+  };
+  const auto sum_list = [](std::uint64_t acc, std::uint64_t v) {
+    return acc + v;
+  };
+  const auto hash = [work](std::uint64_t h) {
+    for (std::size_t i = 0; i < work; ++i) {
+      h = h * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return h;
+  };
+  const auto hash_indirect = [hash](std::uint64_t acc, const auto& kv) {
+    return acc + hash(kv.second->value);
+  };
+  const auto hash_list = [hash](std::uint64_t acc, std::uint64_t v) {
+    return acc + hash(v);
+  };
+  const auto payload_address = [](const auto& kv) { return kv.second.get(); };
+  const auto both_addresses = [](const auto& kv) {
+    return std::array<const void*, 2>{&kv, kv.second.get()};
+  };
+
+  std::cout << size << " elements, prefetch distance " << distance
+            << ", visitor work " << work << "\n";
+
+  {
+    bench::table t{"std::map<u64, u64>, cold cache, trivial visitor"};
+    t.measure("dpsg::fold", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(map, std::uint64_t{0}, sum_map));
+    });
+    t.measure("dpsg::fold(prefetched)", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(
+          dpsg::prefetched(map, distance), std::uint64_t{0}, sum_map));
+    });
+  }
+  {
+    bench::table t{"std::map<u64, unique_ptr<payload>>, cold cache, work"};
+    t.measure("dpsg::fold", bench::flush_caches, [&] {
+      bench::do_not_optimize(
+          dpsg::fold(indirect, std::uint64_t{0}, hash_indirect));
+    });
+    t.measure("dpsg::fold(prefetched, node)", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(dpsg::prefetched(indirect, distance),
+                                        std::uint64_t{0},
+                                        hash_indirect));
+    });
+    t.measure("dpsg::fold(prefetched, payload)", bench::flush_caches, [&] {
+      bench::do_not_optimize(
+          dpsg::fold(dpsg::prefetched(indirect, distance, payload_address),
+                     std::uint64_t{0},
+                     hash_indirect));
+    });
+    t.measure("dpsg::fold(prefetched, node+payload)", bench::flush_caches, [&] {
+      bench::do_not_optimize(
+          dpsg::fold(dpsg::prefetched(indirect, distance, both_addresses),
+                     std::uint64_t{0},
+                     hash_indirect));
+    });
+  }
+  {
+    bench::table t{"std::list<u64>, cold cache, trivial visitor"};
+    t.measure("dpsg::fold", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(list, std::uint64_t{0}, sum_list));
+    });
+    t.measure("dpsg::fold(prefetched)", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(
+          dpsg::prefetched(list, distance), std::uint64_t{0}, sum_list));
+    });
+  }
+  {
+    bench::table t{"std::list<u64>, cold cache, work"};
+    t.measure("dpsg::fold", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(list, std::uint64_t{0}, hash_list));
+    });
+    t.measure("dpsg::fold(prefetched)", bench::flush_caches, [&] {
+      bench::do_not_optimize(dpsg::fold(
+          dpsg::prefetched(list, distance), std::uint64_t{0}, hash_list));
+    });
+  }
+
+  return 0;
+}
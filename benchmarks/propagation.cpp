@@ -0,0 +1,108 @@
+#include <propagation.hpp>
+#include <walk.hpp>
+
+#include "./benchmark.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+// World transforms of a scene graph of 4x4 matrices, computed by passing the
+// parent transform through next() during a walk of the tree, and with a
+// dpsg::propagation_cache updated after a varying number of changes.
+// Usage: propagation [nodes]
+
+struct mat4 {
+  float m[16];
+};
+
+mat4 operator*(const mat4& l, const mat4& r) {
+  mat4 result{};
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      float sum = 0;
+      for (int k = 0; k < 4; ++k) {
+        sum += l.m[i * 4 + k] * r.m[k * 4 + j];
+      }
+      result.m[i * 4 + j] = sum;
+    }
+  }
+  return result;
+}
+
+constexpr mat4 identity{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+
+mat4 translation(float x) {
+  mat4 result = identity;
+  result.m[3] = x;
+  return result;
+}
+
+struct node {
+  mat4 local;
+  mat4 world;
+  std::vector<std::unique_ptr<node>> children;
+};
+
+BENCH_NOINLINE void walk_update(node& root) {
+  dpsg::walk(
+      dpsg::pre_order,
+      root,
+      [](node& n, auto next, const mat4& parent) {
+        n.world = parent * n.local;
+        next(n.world);
+      },
+      identity);
+}
+
+using cache = dpsg::propagation_cache<mat4>;
+
+BENCH_NOINLINE std::size_t cache_update(cache& transforms) {
+  return transforms.update();
+}
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 10'000);
+
+  // Random tree, every node is attached to one of the nodes created before it
+  std::mt19937 random{42};
+  std::vector<node*> nodes;
+  node root{translation(0), identity, {}};
+  nodes.push_back(&root);
+  for (std::size_t i = 1; i < size; ++i) {
+    node* parent = nodes[std::uniform_int_distribution<std::size_t>{
+        i > 64 ? i - 64 : 0, i - 1}(random)];
+    parent->children.push_back(std::make_unique<node>(
+        node{translation(static_cast<float>(i)), identity, {}}));
+    nodes.push_back(parent->children.back().get());
+  }
+
+  cache transforms{identity};
+  transforms.assign(root, [](const node& n) { return n.local; });
+  transforms.update();
+
+  const auto change = [&](std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::size_t n =
+          std::uniform_int_distribution<std::size_t>{0, size - 1}(random);
+      transforms.set_local(n, translation(static_cast<float>(i)));
+    }
+  };
+
+  std::cout << size << " nodes\n";
+  bench::table t{"World transforms"};
+  t.measure("dpsg::walk, next(parent_world)", [&] { walk_update(root); });
+  t.measure(
+      "propagation_cache, everything",
+      [&] { transforms.set_root_state(identity); },
+      [&] { bench::do_not_optimize(cache_update(transforms)); });
+  for (std::size_t changes : {100, 10, 1}) {
+    std::size_t recomputed = 0;
+    t.measure("propagation_cache, " + std::to_string(changes) + " changed",
+              [&] { change(changes); },
+              [&] { recomputed = cache_update(transforms); });
+    std::cout << "  (" << recomputed << " nodes recomputed)\n";
+  }
+  return 0;
+}
@@ -0,0 +1,49 @@
+#include <scan.hpp>
+
+#include "./benchmark.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Running offsets of a large batch of sizes, computed sequentially and with
+// the two-pass parallel scan. Usage: scan [elements]
+
+int main(int argc, char** argv) {
+  const std::size_t size = bench::arg_or(argc, argv, 1, 1 << 25);
+
+  std::mt19937 random{42};
+  std::vector<std::uint32_t> sizes(size);
+  for (auto& s : sizes) {
+    s = std::uniform_int_distribution<std::uint32_t>{0, 4096}(random);
+  }
+  std::vector<std::uint64_t> offsets(size);
+
+  std::cout << size << " elements, " << std::thread::hardware_concurrency()
+            << " hardware threads\n";
+  bench::table t{"Exclusive scan"};
+  t.measure("std::exclusive_scan", [&] {
+    std::exclusive_scan(
+        sizes.begin(), sizes.end(), offsets.begin(), std::uint64_t{0});
+    bench::do_not_optimize(offsets.back());
+  });
+  t.measure("dpsg::exclusive_scan (returns a vector)", [&] {
+    bench::do_not_optimize(
+        dpsg::exclusive_scan(sizes, std::uint64_t{0}, std::plus<>{}).back());
+  });
+  for (std::size_t threads : {2, 4, 8}) {
+    t.measure(
+        "dpsg::parallel_exclusive_scan, " + std::to_string(threads) +
+            " threads",
+        [&] {
+          dpsg::parallel_exclusive_scan(
+              sizes, offsets.begin(), std::uint64_t{0}, std::plus<>{}, threads);
+          bench::do_not_optimize(offsets.back());
+        });
+  }
+  return 0;
+}
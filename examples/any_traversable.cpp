@@ -0,0 +1,110 @@
+#include <any_traversable.hpp>
+#include <traverse.hpp>
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// dpsg::any_traversable erases the type of a traversable object, so that
+// functions can accept any of them without being templates. This is typically
+// what you want at library or plugin boundaries.
+
+// This function is compiled once, whatever is given to it
+int sum(const dpsg::any_traversable<const int&>& values) {
+  int result = 0;
+  dpsg::traverse(values, [&result](int i) { result += i; });
+  return result;
+}
+
+// Elements can be modified through non-const references
+void increment(dpsg::any_traversable<int&>& values) {
+  dpsg::traverse(values, [](int& i) { ++i; });
+}
+
+// Overloads are told apart by the elements of the argument
+std::size_t letters(const dpsg::any_traversable<const int&>&) { return 0; }
+std::size_t letters(const dpsg::any_traversable<const std::string&>& words) {
+  std::size_t result = 0;
+  dpsg::traverse(words,
+                 [&result](const std::string& w) { result += w.size(); });
+  return result;
+}
+
+struct big {
+  std::array<int, 64> values;
+
+  template <class F>
+  friend void dpsg_traverse(const big& b, F&& f) {
+    dpsg::traverse(b.values, f);
+  }
+};
+
+int main() {
+  using handle = dpsg::any_traversable<const int&>;
+  static_assert(dpsg::is_traversable_v<handle>);
+  static_assert(!dpsg::is_traversable_v<const dpsg::any_traversable<int&>&>);
+  static_assert(handle::stores_inline<std::vector<int>>);
+  static_assert(handle::stores_inline<std::tuple<int, short, char>>);
+  static_assert(!handle::stores_inline<big>);
+  // Only traversable objects convert to a handle
+  static_assert(std::is_constructible_v<handle, std::vector<int>>);
+  static_assert(!std::is_constructible_v<handle, int>);
+  static_assert(!std::is_convertible_v<int, handle>);
+  // ... and only when their elements convert to the element type
+  static_assert(!std::is_constructible_v<handle, std::vector<std::string>>);
+  static_assert(
+      !std::is_constructible_v<handle, std::tuple<int, std::string>>);
+  static_assert(!std::is_constructible_v<handle, std::array<std::string, 2>>);
+  static_assert(std::is_constructible_v<handle, std::pair<int, short>>);
+  static_assert(!std::is_constructible_v<dpsg::any_traversable<int&>,
+                                         std::vector<long>>);
+
+  if (sum(std::vector<int>{1, 2, 3}) != 6 ||
+      sum(std::tuple<int, short, char>{1, 2, 3}) != 6 ||
+      sum(std::set<int>{}) != 0 ||
+      sum(std::optional<int>{4}) != 4 ||
+      sum(big{{1, 2, 3}}) != 6 ||
+      letters(std::vector<std::string>{"one", "two"}) != 6 ||
+      letters(std::vector<int>{1, 2}) != 0) {
+    return 1;
+  }
+
+  // Copies are deep, moves leave the source empty
+  handle original{std::vector<int>{1, 2, 3}};
+  handle copy = original;
+  handle moved = std::move(original);
+  if (original.has_value() || sum(copy) != 6 || sum(moved) != 6) {
+    return 1;
+  }
+  handle large{big{{4, 5, 6}}};
+  copy = large;
+  moved = std::move(large);
+  if (sum(copy) != 15 || sum(moved) != 15 || sum(handle{}) != 0) {
+    return 1;
+  }
+
+  dpsg::any_traversable<int&> mutable_values{std::array<int, 3>{1, 2, 3}};
+  increment(mutable_values);
+  int total = 0;
+  dpsg::traverse(mutable_values, [&total](int i) { total += i; });
+  if (total != 9) {
+    return 1;
+  }
+
+  // Extra arguments are given on the caller side of the erasure
+  dpsg::any_traversable<const std::string&> strings{
+      std::tuple<std::string, const char*>{"erased", "traversal"}};
+  dpsg::traverse(
+      strings,
+      [](const std::string& s, std::ostream& out) { out << s << '\n'; },
+      std::cout);
+
+  return 0;
+}
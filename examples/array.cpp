@@ -0,0 +1,86 @@
+#include <fold.hpp>
+#include <traverse.hpp>
+
+#include <array>
+#include <iostream>
+#include <string>
+
+// std::array and C arrays are traversable and foldable out of the box. Small
+// arrays are unrolled at compile time, large ones are iterated over with a
+// loop. The threshold can be chosen for each call with dpsg::with_policy.
+
+static_assert(dpsg::is_traversable_v<std::array<int, 3>>);
+static_assert(dpsg::is_traversable_v<int[3]>);
+static_assert(dpsg::is_traversable_v<const int (&)[3]>);
+static_assert(dpsg::is_foldable_v<std::array<int, 3>, int>);
+static_assert(dpsg::is_foldable_v<int[3], int>);
+
+constexpr auto plus = [](int a, int b) { return a + b; };
+
+static_assert(dpsg::fold(std::array<int, 4>{1, 2, 3, 4}, 0, plus) == 10);
+static_assert(dpsg::fold(std::array<int, 0>{}, 42, plus) == 42);
+
+// Both strategies are usable at compile time
+constexpr std::array<int, 40> make_iota() {
+  std::array<int, 40> result{};
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    result[i] = static_cast<int>(i);
+  }
+  return result;
+}
+constexpr std::array<int, 40> iota = make_iota();
+static_assert(dpsg::fold(iota, 0, plus) == 780);
+static_assert(dpsg::fold(dpsg::with_policy(dpsg::always_unroll, iota),
+                         0,
+                         plus) == 780);
+static_assert(dpsg::fold(dpsg::with_policy(dpsg::never_unroll, iota),
+                         0,
+                         plus) == 780);
+
+constexpr int c_array[] = {1, 2, 3};
+static_assert(dpsg::fold(c_array, 0, plus) == 6);
+static_assert(dpsg::fold(dpsg::with_policy(dpsg::unroll_limit<2>, c_array),
+                         0,
+                         plus) == 6);
+
+// The accumulator may change type on the first application, even in a loop
+static_assert(dpsg::fold(dpsg::with_policy(dpsg::never_unroll, c_array),
+                         'a',
+                         [](auto acc, int i) { return acc + i; }) == 'a' + 6);
+
+constexpr int sum_traversal(const std::array<int, 40>& array) {
+  int sum = 0;
+  dpsg::traverse(array, [&sum](int i) { sum += i; });
+  return sum;
+}
+static_assert(sum_traversal(iota) == 780);
+
+int main() {
+  constexpr auto print = [](const auto& v) {
+    std::cout << "value contained: " << v << "\n";
+  };
+
+  std::array<std::string, 2> strings{"first", "second"};
+  std::string c_strings[] = {"third", "fourth"};
+  dpsg::traverse(strings, print);
+  dpsg::traverse(c_strings, print);
+
+  // Elements of rvalue arrays are forwarded as rvalues
+  std::string stolen;
+  dpsg::traverse(dpsg::with_policy(dpsg::never_unroll, std::move(strings)),
+                 [&stolen](std::string&& s) { stolen += std::move(s); });
+  if (stolen != "firstsecond") {
+    return 1;
+  }
+
+  // Extra arguments are passed along to every call
+  int total = 0;
+  int values[] = {1, 2, 3};
+  dpsg::traverse(
+      values, [](int v, int factor, int& out) { out += v * factor; }, 2, total);
+  if (total != 12) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,293 @@
+#include <async.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Stand-in for a cache daemon: requests are answered on a thread of its own,
+// by batches, and in the reverse of the order in which they arrived so that
+// visits complete out of order.
+class local_cache {
+ public:
+  explicit local_cache(std::size_t batch_size)
+      : batch_size_{batch_size}, worker_{[this] { serve(); }} {}
+
+  local_cache(const local_cache&) = delete;
+  local_cache& operator=(const local_cache&) = delete;
+
+  ~local_cache() {
+    {
+      std::lock_guard lock{mutex_};
+      stopping_ = true;
+    }
+    pending_cv_.notify_one();
+    worker_.join();
+  }
+
+  auto fetch(int key) {
+    struct awaiter {
+      local_cache* cache;
+      int key;
+      std::string value;
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> handle) {
+        cache->submit(request{key, &value, handle});
+      }
+      std::string await_resume() { return std::move(value); }
+    };
+    return awaiter{this, key, {}};
+  }
+
+  // Largest number of requests waiting for an answer at the same time
+  std::size_t max_pending() {
+    std::lock_guard lock{mutex_};
+    return max_pending_;
+  }
+
+ private:
+  struct request {
+    int key;
+    std::string* value;
+    std::coroutine_handle<> handle;
+  };
+
+  void submit(request r) {
+    std::lock_guard lock{mutex_};
+    pending_.push_back(r);
+    max_pending_ = std::max(max_pending_, pending_.size());
+    pending_cv_.notify_one();
+  }
+
+  void serve() {
+    for (;;) {
+      std::vector<request> batch;
+      {
+        std::unique_lock lock{mutex_};
+        pending_cv_.wait_for(lock, std::chrono::milliseconds{50}, [this] {
+          return stopping_ || pending_.size() >= batch_size_;
+        });
+        if (stopping_ && pending_.empty()) {
+          return;
+        }
+        batch.swap(pending_);
+      }
+      for (auto it = batch.rbegin(); it != batch.rend(); ++it) {
+        *it->value = "value " + std::to_string(it->key);
+        it->handle.resume();
+      }
+    }
+  }
+
+  std::size_t batch_size_;
+  std::mutex mutex_;
+  std::condition_variable pending_cv_;
+  std::vector<request> pending_;
+  std::size_t max_pending_{0};
+  bool stopping_{false};
+  std::thread worker_;
+};
+
+// Awaitable through a free operator co_await, found by ADL
+namespace lib {
+struct delay {
+  int value;
+};
+
+inline auto operator co_await(delay d) noexcept {
+  struct awaiter {
+    int value;
+    [[nodiscard]] bool await_ready() const noexcept { return true; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    int await_resume() const noexcept { return value * 10; }
+  };
+  return awaiter{d.value};
+}
+}  // namespace lib
+
+// Runs its work inline, but refuses the n-th piece of work it is given
+struct refusing_executor {
+  std::size_t refused;
+  std::size_t calls = 0;
+
+  template <class F>
+  void execute(F&& f) {
+    if (++calls == refused) {
+      throw std::runtime_error{"executor refused"};
+    }
+    std::forward<F>(f)();
+  }
+};
+
+// Fetches every key and returns the number of values received
+dpsg::task<std::size_t> fetch_all(dpsg::thread_pool& pool,
+                                  local_cache& cache,
+                                  const std::vector<int>& keys,
+                                  std::size_t max_concurrency) {
+  std::size_t received = 0;
+  co_await dpsg::async_traverse(
+      dpsg::unordered,
+      pool,
+      keys,
+      [&cache](int key) { return cache.fetch(key); },
+      [&received](const std::string&) { ++received; },
+      max_concurrency);
+  co_return received;
+}
+
+int main() {
+  constexpr std::size_t max_concurrency = 4;
+  dpsg::thread_pool pool{2};
+  std::vector<int> keys(40);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<std::string> expected;
+  for (int key : keys) {
+    expected.push_back("value " + std::to_string(key));
+  }
+
+  // Ordered completions follow the order of the elements, whatever the order
+  // in which the visits finish
+  {
+    local_cache cache{max_concurrency};
+    std::vector<std::string> values;
+    dpsg::sync_wait(dpsg::async_traverse(
+        dpsg::ordered,
+        pool,
+        keys,
+        [&cache](int key) { return cache.fetch(key); },
+        [&values](std::string value) { values.push_back(std::move(value)); },
+        max_concurrency));
+    std::cout << "ordered:   " << values.front() << ", " << values[1]
+              << ", ... (at most " << cache.max_pending()
+              << " requests at once)\n";
+    if (values != expected || cache.max_pending() != max_concurrency) {
+      return 1;
+    }
+  }
+
+  // Unordered completions come as soon as each visit is over
+  {
+    local_cache cache{max_concurrency};
+    std::vector<std::string> values;
+    dpsg::sync_wait(dpsg::async_traverse(
+        dpsg::unordered,
+        pool,
+        keys,
+        [&cache](int key) { return cache.fetch(key); },
+        [&values](std::string value) { values.push_back(std::move(value)); },
+        max_concurrency));
+    std::cout << "unordered: " << values.front() << ", " << values[1]
+              << ", ... (at most " << cache.max_pending()
+              << " requests at once)\n";
+    if (values == expected || cache.max_pending() != max_concurrency) {
+      return 1;
+    }
+    std::sort(values.begin(), values.end());
+    std::sort(expected.begin(), expected.end());
+    if (values != expected) {
+      return 1;
+    }
+  }
+
+  // The traversal can be awaited by another task
+  {
+    local_cache cache{1};
+    if (dpsg::sync_wait(fetch_all(pool, cache, keys, 1)) != keys.size() ||
+        cache.max_pending() != 1) {
+      return 1;
+    }
+  }
+
+  // The first exception is rethrown once the running visits are over
+  {
+    local_cache cache{max_concurrency};
+    std::size_t visited = 0;
+    try {
+      dpsg::sync_wait(dpsg::async_traverse(
+          pool,
+          keys,
+          [&cache, &visited](int key) -> dpsg::task<> {
+            auto value = co_await cache.fetch(key);
+            if (key == 13) {
+              throw std::runtime_error{"no " + value};
+            }
+            ++visited;
+          },
+          max_concurrency));
+      return 1;
+    }
+    catch (const std::runtime_error& error) {
+      std::cout << "failed with: " << error.what() << " after " << visited
+                << " visits\n";
+      if (std::string{error.what()} != "no value 13" ||
+          visited >= keys.size() - 1) {
+        return 1;
+      }
+    }
+  }
+
+  // Executors failing to schedule a visit are reported as errors too
+  {
+    refusing_executor executor{3};
+    std::size_t visited = 0;
+    try {
+      dpsg::sync_wait(dpsg::async_traverse(
+          executor, keys, [&visited](int) { ++visited; }, 1));
+      return 1;
+    }
+    catch (const std::runtime_error& error) {
+      if (std::string{error.what()} != "executor refused") {
+        return 1;
+      }
+    }
+  }
+
+  // Awaitables with a free operator co_await are awaited, not passed on
+  {
+    std::vector<int> awaited;
+    dpsg::inline_executor executor;
+    dpsg::sync_wait(dpsg::async_traverse(
+        dpsg::ordered,
+        executor,
+        std::vector<int>{1, 2, 3},
+        [](int k) { return lib::delay{k}; },
+        [&awaited](int value) { awaited.push_back(value); },
+        0));
+    if (awaited != std::vector<int>{10, 20, 30}) {
+      return 1;
+    }
+  }
+
+  // Synchronous visitors and heterogeneous elements, on the calling thread
+  {
+    std::tuple<int, double, std::string> values{1, 2.5, "three"};
+    std::string described;
+    dpsg::inline_executor executor;
+    dpsg::sync_wait(dpsg::async_traverse(
+        dpsg::ordered,
+        executor,
+        values,
+        [](const auto& v) {
+          if constexpr (std::is_same_v<std::decay_t<decltype(v)>,
+                                       std::string>) {
+            return v;
+          }
+          else {
+            return std::to_string(v);
+          }
+        },
+        [&described](const std::string& s) { described += s + " "; },
+        0));
+    if (described != "1 2.500000 three ") {
+      return 1;
+    }
+  }
+}
@@ -0,0 +1,149 @@
+#include <batch.hpp>
+#include <composite.hpp>
+
+#include "./overload_set.hpp"
+
+#include <iostream>
+#include <list>
+#include <ranges>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// dpsg::traverse_batched gives the visitor groups of elements of the same type
+// rather than single elements. Here a scene issues one "draw call" per kind of
+// shape, and a log is written to a pretend database in chunks.
+
+namespace scene {
+struct circle {
+  float radius;
+};
+struct square {
+  float side;
+};
+}  // namespace scene
+
+template <class... Args>
+struct layer : dpsg::composite<Args...> {
+  template <class... Args2>
+  constexpr explicit layer(Args2&&... args)
+      : dpsg::composite<Args...>{std::forward<Args2>(args)...} {}
+};
+template <class... Args>
+layer(Args&&...) -> layer<Args...>;
+
+// Grouping happens at compile time, so it is available in constant expressions
+constexpr float total_radius() {
+  std::tuple shapes{scene::circle{1}, scene::square{2}, scene::circle{3}};
+  float result = 0;
+  dpsg::traverse_batched(shapes,
+                         overload_set{
+                             [&result](dpsg::batch<scene::circle, 2> circles) {
+                               for (auto& c : circles) {
+                                 result += c.radius;
+                               }
+                             },
+                             [](dpsg::batch<scene::square, 1>) {},
+                         });
+  return result;
+}
+static_assert(total_radius() == 4);
+
+int main() {
+  std::string draw_calls;
+  const auto draw = overload_set{
+      [&draw_calls](auto circles, int pass)
+          -> decltype(circles[0].radius, void()) {
+        draw_calls += "pass " + std::to_string(pass) + ": " +
+                      std::to_string(circles.size()) + " circles\n";
+      },
+      [&draw_calls](auto squares, int pass)
+          -> decltype(squares[0].side, void()) {
+        draw_calls += "pass " + std::to_string(pass) + ": " +
+                      std::to_string(squares.size()) + " squares\n";
+      },
+  };
+
+  const std::tuple shapes{scene::circle{1},
+                          scene::square{2},
+                          scene::circle{3},
+                          scene::square{4},
+                          scene::circle{5}};
+  dpsg::traverse_batched(shapes, draw, 1);
+
+  // For composites, the direct components are grouped
+  const layer l{scene::square{1}, scene::circle{2}, scene::square{3}};
+  dpsg::traverse_batched(l, draw, 2);
+
+  std::cout << draw_calls;
+  if (draw_calls !=
+      "pass 1: 3 circles\npass 1: 2 squares\n"
+      "pass 2: 2 squares\npass 2: 1 circles\n") {
+    return 1;
+  }
+
+  // Elements keep their original order within a group
+  std::string order;
+  dpsg::traverse_batched(std::tuple{1, 'a', 2, 'b', 3},
+                         [&order](const auto& group) {
+                           for (const auto& e : group) {
+                             order += std::to_string(e) + " ";
+                           }
+                         });
+  if (order != "1 2 3 97 98 ") {
+    return 1;
+  }
+
+  // Contiguous ranges are given as std::span
+  std::vector<int> log(10);
+  std::vector<std::size_t> chunk_sizes;
+  dpsg::traverse_batched<4>(log, [&chunk_sizes](std::span<int> chunk) {
+    chunk_sizes.push_back(chunk.size());
+    for (int& i : chunk) {
+      ++i;
+    }
+  });
+  if (chunk_sizes != std::vector<std::size_t>{4, 4, 2}) {
+    return 1;
+  }
+  for (int i : log) {
+    if (i != 1) {
+      return 1;
+    }
+  }
+
+  // Other ranges as batches of references
+  std::list<int> list{1, 2, 3, 4, 5};
+  chunk_sizes.clear();
+  int sum = 0;
+  dpsg::traverse_batched<2>(
+      list, [&chunk_sizes, &sum](dpsg::batch<int, 2> chunk) {
+        chunk_sizes.push_back(chunk.size());
+        for (int i : chunk) {
+          sum += i;
+        }
+      });
+  if (chunk_sizes != std::vector<std::size_t>{2, 2, 1} || sum != 15) {
+    return 1;
+  }
+
+#if defined(__cpp_lib_ranges)
+  // Views producing their elements on the fly are buffered, a chunk never
+  // refers to a temporary of the loop
+  const auto squares = std::views::iota(1, 8) |
+                       std::views::transform([](int i) { return i * i; });
+  chunk_sizes.clear();
+  std::vector<int> seen;
+  dpsg::traverse_batched<3>(
+      squares, [&chunk_sizes, &seen](dpsg::batch<int, 3> chunk) {
+        chunk_sizes.push_back(chunk.size());
+        seen.insert(seen.end(), chunk.begin(), chunk.end());
+      });
+  if (chunk_sizes != std::vector<std::size_t>{3, 3, 1} ||
+      seen != std::vector<int>{1, 4, 9, 16, 25, 36, 49}) {
+    return 1;
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <by_alternative.hpp>
+#include <fold.hpp>
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Ranges of variants visited one alternative at a time: dispatch happens once
+// per run of elements holding the same alternative, not once per element.
+
+struct circle {
+  double radius;
+};
+struct square {
+  double side;
+};
+struct label {
+  std::string text;
+};
+
+using shape = std::variant<circle, square, label>;
+
+struct area {
+  double operator()(double acc, const circle& c) const {
+    return acc + 3 * c.radius * c.radius;
+  }
+  double operator()(double acc, const square& s) const {
+    return acc + s.side * s.side;
+  }
+  double operator()(double acc, const label&) const { return acc; }
+};
+
+struct describe {
+  void operator()(const circle& c, std::string& out) const {
+    out += 'c';
+    out += std::to_string(static_cast<int>(c.radius));
+  }
+  void operator()(const square& s, std::string& out) const {
+    out += 's';
+    out += std::to_string(static_cast<int>(s.side));
+  }
+  void operator()(const label& l, std::string& out) const { out += l.text; }
+};
+
+// What dpsg::fold does: std::visit on every element
+double fold_visiting(const std::vector<shape>& shapes) {
+  return dpsg::fold(shapes, 0.0, [](double acc, const shape& s) {
+    return dpsg::fold(s, acc, area{});
+  });
+}
+
+int main() {
+  std::vector<shape> shapes{circle{1}, circle{2}, square{3}, label{"a"},
+                            circle{4}, square{5}, square{6}, label{"b"}};
+  const double expected = fold_visiting(shapes);
+
+  // Runs are visited in order
+  std::string order;
+  dpsg::traverse_by_alternative(shapes, describe{}, order);
+  std::cout << "in order:        " << order << "\n";
+  if (order != "c1c2s3ac4s5s6b" ||
+      dpsg::fold_by_alternative(shapes, 0.0, area{}) != expected) {
+    return 1;
+  }
+
+  // The prebuilt index groups the alternatives without reordering the range
+  dpsg::alternative_index index{shapes};
+  if (index.size() != shapes.size() || index.positions(1).size() != 3 ||
+      index.positions(2) != std::vector<std::size_t>{3, 7}) {
+    return 1;
+  }
+  order.clear();
+  index.traverse(shapes, describe{}, order);
+  std::cout << "with an index:   " << order << "\n";
+  if (order != "c1c2c4s3s5s6ab" ||
+      index.fold(shapes, 0.0, area{}) != expected) {
+    return 1;
+  }
+
+  // Values may change as long as alternatives stay the same
+  index.traverse(shapes, [](auto& s) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(s)>, square>) {
+      s.side *= 2;
+    }
+  });
+  if (fold_visiting(shapes) != expected + 3 * (9 + 25 + 36)) {
+    return 1;
+  }
+
+  // Sorting makes one run per alternative, keeping the relative order of the
+  // elements
+  dpsg::sort_by_alternative(shapes);
+  order.clear();
+  dpsg::traverse_by_alternative(shapes, describe{}, order);
+  std::cout << "sorted:          " << order << "\n";
+  if (order != "c1c2c4s6s10s12ab") {
+    return 1;
+  }
+
+  // Any range works for the run-based functions, const ones included
+  const std::list<shape> list{square{1}, square{2}, circle{1}};
+  if (dpsg::fold_by_alternative(list, 0.0, area{}) != 1 + 4 + 3) {
+    return 1;
+  }
+
+  // Valueless variants are reported as by std::visit
+  struct throws_on_copy {
+    throws_on_copy() = default;
+    throws_on_copy(const throws_on_copy&) { throw 0; }
+  };
+  std::vector<std::variant<int, throws_on_copy>> broken(1);
+  try {
+    broken[0] = throws_on_copy{};
+  }
+  catch (int) {
+  }
+  try {
+    dpsg::traverse_by_alternative(broken, [](const auto&) {});
+    return 1;
+  }
+  catch (const std::bad_variant_access&) {
+  }
+
+  // Sorting checks every element before moving any
+  std::vector<std::variant<std::string, throws_on_copy>> texts{
+      std::string{"first"}, std::string{"second"}, std::string{"third"}};
+  try {
+    texts[1] = throws_on_copy{};
+  }
+  catch (int) {
+  }
+  try {
+    dpsg::sort_by_alternative(texts);
+    return 1;
+  }
+  catch (const std::bad_variant_access&) {
+  }
+  if (std::get<0>(texts[0]) != "first" || std::get<0>(texts[2]) != "third") {
+    return 1;
+  }
+}
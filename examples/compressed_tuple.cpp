@@ -0,0 +1,163 @@
+#include <batch.hpp>
+#include <composite.hpp>
+#include <compressed_tuple.hpp>
+#include <fold.hpp>
+#include <only.hpp>
+#include <traverse.hpp>
+#include <unroll.hpp>
+
+#include <any>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// dpsg::compressed_tuple is the storage of dpsg::composite: empty elements
+// take no room and the elements are reordered to minimize padding, while
+// keeping the declaration order for everything observable.
+
+struct empty {};
+struct other_empty {};
+
+using padded = std::tuple<char, double, char, std::int32_t, char>;
+using compressed =
+    dpsg::compressed_tuple<char, double, char, std::int32_t, char>;
+
+// Leaves of a static hierarchy, as in composite.cpp
+namespace doc {
+struct br : dpsg::composite<> {};
+struct p : dpsg::composite<> {
+  constexpr explicit p(const char* text) noexcept : text{text} {}
+  const char* text;
+};
+template <class... Args>
+struct div : dpsg::composite<Args...> {
+  template <class... Args2>
+  constexpr explicit div(Args2&&... args)
+      : dpsg::composite<Args...>{std::forward<Args2>(args)...} {}
+};
+template <class... Args>
+div(Args&&...) -> div<Args...>;
+}  // namespace doc
+using doc::br;
+using doc::p;
+
+constexpr doc::div document{br{}, p{"a"}, br{}, doc::div{p{"b"}, br{}}, br{}};
+
+static_assert(sizeof(compressed) < sizeof(padded));
+static_assert(sizeof(compressed) == 8 + 4 + 3 * 1 + 1);
+static_assert(sizeof(dpsg::compressed_tuple<empty, int, other_empty>) ==
+              sizeof(int));
+// Two objects of the same type can't share an address
+static_assert(sizeof(dpsg::compressed_tuple<empty, int, empty>) >
+              sizeof(int));
+static_assert(std::is_empty_v<dpsg::compressed_tuple<>>);
+static_assert(std::is_empty_v<br>);
+static_assert(sizeof(document) == 3 * sizeof(const char*));
+
+// Elements keep their declared indices, and can be used at compile time
+constexpr compressed values{'a', 1.5, 'b', 42, 'c'};
+static_assert(dpsg::get<0>(values) == 'a' && dpsg::get<1>(values) == 1.5 &&
+              dpsg::get<3>(values) == 42 && dpsg::get<4>(values) == 'c');
+static_assert(std::tuple_size_v<compressed> == 5);
+static_assert(
+    std::is_same_v<std::tuple_element_t<3, compressed>, std::int32_t>);
+
+int main() {
+  std::cout << "sizeof(std::tuple<char, double, char, int32_t, char>)      = "
+            << sizeof(padded) << "\n"
+            << "sizeof(compressed_tuple<char, double, char, int32_t, char>) = "
+            << sizeof(compressed) << "\n"
+            << "sizeof(compressed_tuple<empty, int, other_empty>)           = "
+            << sizeof(dpsg::compressed_tuple<empty, int, other_empty>) << "\n"
+            << "sizeof(document)                                            = "
+            << sizeof(document) << "\n";
+
+  // Traversal and folds follow the declaration order
+  std::string order;
+  dpsg::traverse(values, [&order](auto v) {
+    order += std::to_string(static_cast<int>(v)) + " ";
+  });
+  if (order != "97 1 98 42 99 ") {
+    return 1;
+  }
+  if (dpsg::fold(values, 0.0, [](double acc, auto v) {
+        return acc * 2 + static_cast<double>(v);
+      }) != (((97 * 2 + 1.5) * 2 + 98) * 2 + 42) * 2 + 99) {
+    return 1;
+  }
+
+  std::string texts;
+  dpsg::traverse(document, [&texts](const auto& node, auto next) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(node)>, p>) {
+      texts += node.text;
+    }
+    else if constexpr (std::is_same_v<std::decay_t<decltype(node)>, br>) {
+      texts += '|';
+    }
+    next();
+  });
+  if (texts != "|a|b||") {
+    return 1;
+  }
+  int paragraphs = 0;
+  dpsg::traverse_only<p>(document, [&paragraphs](const p&) { ++paragraphs; });
+  int breaks = 0;
+  dpsg::traverse_batched(document, [&breaks](auto batch) {
+    if constexpr (std::is_same_v<typename decltype(batch)::value_type, br>) {
+      breaks += static_cast<int>(batch.size());
+    }
+  });
+  if (paragraphs != 2 || breaks != 3) {
+    return 1;
+  }
+
+  // Structured bindings and modifications
+  compressed copy = values;
+  auto& [a, b, c, d, e] = copy;
+  b = 2.5;
+  dpsg::get<3>(copy) += 1;
+  if (a != 'a' || dpsg::get<1>(copy) != 2.5 || d != 43 || c != 'b' ||
+      e != 'c') {
+    return 1;
+  }
+
+  // Copying from a non-const lvalue copies, even when the only element could
+  // be built from the tuple itself
+  dpsg::compressed_tuple<std::any> boxed{std::any{1}};
+  dpsg::compressed_tuple<std::any> boxed_copy{boxed};
+  if (std::any_cast<int>(dpsg::get<0>(boxed_copy)) != 1) {
+    return 1;
+  }
+
+  // Reference elements behave as with std::get, even from an rvalue
+  int target = 1;
+  dpsg::compressed_tuple<int&, double> refs{target, 2.0};
+  static_assert(std::is_same_v<decltype(dpsg::get<0>(std::move(refs))), int&>);
+  static_assert(
+      std::is_same_v<decltype(dpsg::get<1>(std::move(refs))), double&&>);
+  dpsg::get<0>(std::move(refs)) = 5;
+  if (target != 5) {
+    return 1;
+  }
+
+  // Indexed dispatch (used above DPSG_DEFAULT_TUPLE_UNROLL_LIMIT elements)
+  // gives the same results as unrolling
+  std::string dispatched;
+  dpsg::traverse(dpsg::with_policy(dpsg::never_unroll, values),
+                 [&dispatched](auto v) {
+                   dispatched += std::to_string(static_cast<int>(v)) + " ";
+                 });
+  if (dispatched != order ||
+      dpsg::fold(dpsg::with_policy(dpsg::never_unroll, values),
+                 0.0,
+                 [](double acc, auto v) {
+                   return acc + static_cast<double>(v);
+                 }) != 97 + 1.5 + 98 + 42 + 99) {
+    return 1;
+  }
+
+  return 0;
+}
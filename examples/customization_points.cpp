@@ -1,10 +1,7 @@
-#if defined(_MSC_VER)
-#include "traverse.hpp"  // See below
-#endif
-
 #include <iostream>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <variant>
 
 // This file demonstrate 3 ways to make your own type traversable.
@@ -14,6 +11,30 @@
 // dpsg::customization_points namespace (avoid it unless you have a really good
 // reason to do that)
 
+// Last resort (strongly discouraged), if for some reason you can't overload
+// dpsg_traverse in the namespace the class is defined in, open
+// dpsg::customization_points and add your own specialization. Note that this
+// puts you at risk of creating ambiguous specializations if you're not careful.
+
+namespace dpsg::customization_points {
+template <class F>
+void dpsg_traverse(const std::string& str, F&& f) {
+  std::forward<F>(f)(str);
+}
+
+// Uncommenting the following will cause ambiguity in the function selection and
+// fail the build
+/*
+template <class E, class F>
+void dpsg_traverse(const E& str, F&& f) {}
+*/
+}  // namespace dpsg::customization_points
+
+// for reasons, if you open dpsg::customization_points to add code there, you'll
+// need to include traverse.hpp AFTER the declaration of the function. This is
+// why this last example comes first in this file, the other 2 don't need that.
+#include "traverse.hpp"
+
 // Intrusive customization, use a friend function directly inside your object
 template <class... Args>
 struct tpl : std::tuple<Args...> {
@@ -51,29 +72,6 @@ void dpsg_traverse(const E& e, F&& f) {
 
 }  // namespace example
 
-// Last resort (strongly discouraged), if for some reason you can't overload
-// dpsg_traverse in the namespace the class is defined in, open
-// dpsg::customization_points and add your own specialization. Note that this
-// puts you at risk of creating ambiguous specializations if you're not careful.
-
-namespace dpsg::customization_points {
-template <class F>
-void dpsg_traverse(const std::string& str, F&& f) {
-  std::forward<F>(f)(str);
-}
-
-// Uncommenting the following will cause ambiguity in the function selection and
-// fail the build
-/*
-template <class E, class F>
-void dpsg_traverse(const E& str, F&& f) {}
-*/
-}  // namespace dpsg::customization_points
-
-// for reasons, if you open dpsg::customization_points to add code there, you'll
-// need to include traverse.hpp AFTER the declaration of the function (I put the
-// whole code above but the other 2 examples don't need that) .
-#include "traverse.hpp"
 
 int main() {
   constexpr auto print = [](const auto& v) {
@@ -93,5 +91,16 @@ int main() {
                  print);  // implicit conversion to std::string
 #endif
 
+  // Customizations take precedence over the loop used for other ranges,
+  // whatever the constness of the argument
+  std::string text{"visited as a whole"};
+  int visits = 0;
+  dpsg::traverse(text, [&visits](const std::string&) { ++visits; });
+  dpsg::traverse(std::as_const(text),
+                 [&visits](const std::string&) { ++visits; });
+  if (visits != 2) {
+    return 1;
+  }
+
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Large tuples are traversed through indexed dispatch: a runtime loop over
+// a table of handlers instantiated once per distinct element type, instead
+// of one inlined call per element. dpsg::with_policy chooses the strategy
+// for a single call.
+
+// Lowered from its default (128) to keep this file quick to compile
+#define DPSG_DEFAULT_TUPLE_UNROLL_LIMIT 64
+
+#include <fold.hpp>
+#include <traverse.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+template <std::size_t I>
+using element_t = std::conditional_t<
+    I % 3 == 0,
+    int,
+    std::conditional_t<I % 3 == 1, std::int64_t, double>>;
+
+template <std::size_t... Is>
+constexpr std::tuple<element_t<Is>...> make_tuple_of(
+    [[maybe_unused]] std::index_sequence<Is...> marker) {
+  return {static_cast<element_t<Is>>(Is)...};
+}
+
+// Above DPSG_DEFAULT_TUPLE_UNROLL_LIMIT
+constexpr auto big = make_tuple_of(std::make_index_sequence<100>{});
+constexpr auto small = make_tuple_of(std::make_index_sequence<5>{});
+
+constexpr auto sum = [](double acc, auto v) {
+  return acc + static_cast<double>(v);
+};
+
+// Constant evaluation always unrolls, whatever the policy
+static_assert(dpsg::fold(big, 0.0, sum) == 4950.0);
+static_assert(dpsg::fold(dpsg::with_policy(dpsg::never_unroll, small),
+                         0.0,
+                         sum) == 10.0);
+
+constexpr double traversal_sum() {
+  double result = 0;
+  dpsg::traverse(big, [&result](auto v) { result += static_cast<double>(v); });
+  return result;
+}
+static_assert(traversal_sum() == 4950.0);
+
+int main() {
+  // Elements are visited in order, with the extra arguments
+  std::string order;
+  std::size_t expected = 0;
+  bool in_order = true;
+  dpsg::traverse(
+      big,
+      [&](auto v, std::string& out) {
+        in_order = in_order && static_cast<std::size_t>(v) == expected++;
+        out += std::is_same_v<decltype(v), int>            ? 'i'
+               : std::is_same_v<decltype(v), std::int64_t> ? 'l'
+                                                           : 'd';
+      },
+      order);
+  if (!in_order || expected != 100 || order.substr(0, 6) != "ildild") {
+    return 1;
+  }
+
+  // Elements are modifiable through non-const tuples
+  auto copy = big;
+  dpsg::traverse(copy, [](auto& v) { v *= 2; });
+  if (std::get<99>(copy) != 198 || dpsg::fold(copy, 0.0, sum) != 9900.0) {
+    return 1;
+  }
+
+  // Rvalue tuples give rvalue elements
+  int rvalues = 0;
+  dpsg::traverse(
+      std::tuple<std::string, std::string>{"a", "b"},
+      [&rvalues](auto&& s) {
+        rvalues += std::is_rvalue_reference_v<decltype(s)> ? 1 : 0;
+      });
+  dpsg::traverse(dpsg::with_policy(dpsg::never_unroll,
+                                   std::tuple<std::string, int>{"a", 1}),
+                 [&rvalues](auto&& s) {
+                   rvalues += std::is_rvalue_reference_v<decltype(s)> ? 1 : 0;
+                 });
+  if (rvalues != 4) {
+    return 1;
+  }
+
+  // The strategy can be chosen for each call
+  double unrolled = 0;
+  double indexed = 0;
+  dpsg::traverse(dpsg::with_policy(dpsg::always_unroll, big),
+                 [&unrolled](auto v) { unrolled += static_cast<double>(v); });
+  dpsg::traverse(dpsg::with_policy(dpsg::never_unroll, small),
+                 [&indexed](auto v) { indexed += static_cast<double>(v); });
+  if (unrolled != 4950.0 || indexed != 10.0 ||
+      dpsg::fold(dpsg::with_policy(dpsg::unroll_limit<2>, small), 0.0, sum) !=
+          10.0) {
+    return 1;
+  }
+
+  // Folds whose accumulator changes type are unrolled
+  const auto concat = [](auto acc, auto v) {
+    return acc + std::to_string(static_cast<int>(v));
+  };
+  if (dpsg::fold(dpsg::with_policy(dpsg::never_unroll, small), "", concat) !=
+      "01234") {
+    return 1;
+  }
+
+  return 0;
+}
@@ -1,5 +1,9 @@
 #include <fold.hpp>
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "./overload_set.hpp"
 
 // A fold is similar to a traversal in that it operates sequencially over
@@ -31,6 +35,19 @@ static_assert(dpsg::fold(std::optional<int>{}, 0, [](int a, int b) {
                 return a + b;
               }) == 0);
 
+// Ranges are folded with a loop, the accumulator keeps the type of the initial
+// value
+static_assert(dpsg::is_foldable_v<std::vector<int>, int>);
+static_assert(dpsg::fold(std::vector<int>{1, 2, 3}, 0, [](int a, int b) {
+                return a + b;
+              }) == 6);
+
+// Strings and string literals are text, not containers of characters
+static_assert(!dpsg::is_foldable_v<std::string, int>);
+static_assert(!dpsg::is_foldable_v<std::string_view, int>);
+static_assert(!dpsg::is_foldable_v<const char (&)[3], int>);
+static_assert(dpsg::is_foldable_v<std::vector<char>, int>);
+
 int main() {
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include <json.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <new>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+// dpsg::json writes and reads JSON following the static shape of the types,
+// without building any intermediate document.
+
+// Counts the allocations made by the whole program, to check that writing
+// doesn't allocate
+static std::size_t allocations = 0;
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace model {
+struct point {
+  double x;
+  double y;
+
+  template <
+      class Self,
+      class F,
+      std::enable_if_t<std::is_same_v<std::decay_t<Self>, point>, int> = 0>
+  friend void dpsg_traverse(Self& p, F&& f) {
+    f(p.x);
+    f(p.y);
+  }
+};
+
+// Named elements are written as objects
+constexpr std::array<std::string_view, 2> dpsg_json_fields(const point&) {
+  return {"x", "y"};
+}
+
+struct shape {
+  std::string name;
+  std::vector<point> points;
+  std::optional<std::string> color;
+  std::variant<std::monostate, int, std::string> tag;
+
+  template <
+      class Self,
+      class F,
+      std::enable_if_t<std::is_same_v<std::decay_t<Self>, shape>, int> = 0>
+  friend void dpsg_traverse(Self& s, F&& f) {
+    f(s.name);
+    f(s.points);
+    f(s.color);
+    f(s.tag);
+  }
+};
+constexpr std::array<std::string_view, 4> dpsg_json_fields(const shape&) {
+  return {"name", "points", "color", "tag"};
+}
+}  // namespace model
+
+template <class T>
+std::string to_json(const T& value) {
+  char buffer[512];
+  auto [end, ec] = dpsg::json::write(buffer, buffer + sizeof(buffer), value);
+  if (ec != std::errc{}) {
+    return "<error>";
+  }
+  return std::string{buffer, end};
+}
+
+template <class T>
+bool round_trips(const T& value, std::string_view expected) {
+  const std::string json = to_json(value);
+  if (json != expected) {
+    std::cout << "wrote " << json << ", expected " << expected << "\n";
+    return false;
+  }
+  T result{};
+  const char* const last = json.data() + json.size();
+  auto [ptr, ec] = dpsg::json::read(json.data(), last, result);
+  if (ec != std::errc{} || ptr != last) {
+    std::cout << "failed to read " << json << "\n";
+    return false;
+  }
+  if (to_json(result) != expected) {
+    std::cout << "read " << to_json(result) << ", expected " << expected
+              << "\n";
+    return false;
+  }
+  return true;
+}
+
+template <class T>
+std::errc read_error(std::string_view json) {
+  T result{};
+  return dpsg::json::read(json.data(), json.data() + json.size(), result).ec;
+}
+
+int main() {
+  bool ok =
+      round_trips(42, "42") && round_trips(-1.5, "-1.5") &&
+      round_trips(true, "true") && round_trips(std::string{"a\"b\\c\n"},
+                                               R"("a\"b\\c\n")") &&
+      round_trips(std::tuple<int, bool, std::string>{1, false, "x"},
+                  R"([1,false,"x"])") &&
+      round_trips(std::pair<int, double>{1, 0.25}, "[1,0.25]") &&
+      round_trips(std::array<int, 3>{1, 2, 3}, "[1,2,3]") &&
+      round_trips(std::vector<std::vector<int>>{{1}, {}, {2, 3}},
+                  "[[1],[],[2,3]]") &&
+      round_trips(std::list<int>{4, 5}, "[4,5]") &&
+      round_trips(std::set<std::string>{"a", "b"}, R"(["a","b"])") &&
+      round_trips(std::map<std::string, int>{{"one", 1}, {"two", 2}},
+                  R"([["one",1],["two",2]])") &&
+      round_trips(std::optional<int>{}, "null") &&
+      round_trips(std::optional<int>{3}, "3") &&
+      round_trips(std::variant<int, std::string>{"v"}, R"([1,"v"])") &&
+      round_trips(model::point{1, 2}, R"({"x":1,"y":2})") &&
+      round_trips(
+          model::shape{"triangle",
+                       {{0, 0}, {1, 0}, {0, 1}},
+                       std::nullopt,
+                       std::string{"tag"}},
+          R"({"name":"triangle","points":[{"x":0,"y":0},{"x":1,"y":0},)"
+          R"({"x":0,"y":1}],"color":null,"tag":[2,"tag"]})");
+  if (!ok) {
+    return 1;
+  }
+
+  // Writing never allocates
+  const model::shape shape{
+      "square", {{0, 0}, {1, 0}, {1, 1}, {0, 1}}, "red", 4};
+  char buffer[256];
+  const std::size_t before = allocations;
+  auto written = dpsg::json::write(buffer, buffer + sizeof(buffer), shape);
+  if (allocations != before || written.ec != std::errc{}) {
+    return 1;
+  }
+  std::cout << std::string_view{buffer, static_cast<std::size_t>(
+                                            written.ptr - buffer)}
+            << "\n";
+
+  // Reading reuses the storage of the target
+  model::shape target;
+  target.points.reserve(8);
+  target.name.reserve(32);
+  target.color.emplace().reserve(32);
+  const std::size_t before_read = allocations;
+  auto read = dpsg::json::read(buffer, written.ptr, target);
+  if (allocations != before_read || read.ec != std::errc{} ||
+      target.points.size() != 4 || target.color != "red" ||
+      std::get<int>(target.tag) != 4) {
+    return 1;
+  }
+
+  // Whitespace and escapes are handled when reading
+  std::tuple<std::string, std::vector<int>> spaced;
+  const std::string_view input =
+      " [ \"caf\\u00e9 \\ud83d\\ude00\" ,\n [ 1 , 2 ] ] ";
+  if (dpsg::json::read(input.data(), input.data() + input.size(), spaced).ec !=
+          std::errc{} ||
+      std::get<0>(spaced) != "caf\xc3\xa9 \xf0\x9f\x98\x80" ||
+      std::get<1>(spaced) != std::vector<int>{1, 2}) {
+    return 1;
+  }
+
+  // Object members may come in any order, unknown members are skipped and
+  // missing ones leave their element as it was
+  const auto read_point = [](std::string_view json, model::point& p) {
+    const char* const last = json.data() + json.size();
+    const auto [ptr, ec] = dpsg::json::read(json.data(), last, p);
+    return ec == std::errc{} && ptr == last;
+  };
+  model::point reordered{};
+  model::point extra{};
+  model::point escaped{};
+  model::point partial{5, 6};
+  if (!read_point(R"({"y":2,"x":1})", reordered) || reordered.x != 1 ||
+      reordered.y != 2 ||
+      !read_point(R"({ "x" : 1, "z" : {"a": [1, "s\"", null, true, 1e400],)"
+                  R"( "b": {}}, "y" : 2, "w": [] })",
+                  extra) ||
+      extra.x != 1 || extra.y != 2 ||
+      !read_point(R"({"\u0079":4,"x":3})", escaped) || escaped.x != 3 ||
+      escaped.y != 4 || !read_point(R"({"y":1})", partial) ||
+      partial.x != 5 || partial.y != 1 || !read_point("{}", partial)) {
+    return 1;
+  }
+
+  // Errors
+  char tiny[4];
+  if (dpsg::json::write(tiny, tiny + sizeof(tiny), std::string{"too long"})
+              .ec != std::errc::value_too_large ||
+      read_error<int>("\"1\"") != std::errc::invalid_argument ||
+      read_error<std::uint8_t>("300") != std::errc::result_out_of_range ||
+      read_error<std::tuple<int, int>>("[1]") != std::errc::invalid_argument ||
+      read_error<std::tuple<int>>("[1,2]") != std::errc::invalid_argument ||
+      read_error<model::point>(R"({"x":1,})") !=
+          std::errc::invalid_argument ||
+      read_error<model::point>(R"({"x" 1})") != std::errc::invalid_argument ||
+      read_error<model::point>(R"({"x":1,"z":tru})") !=
+          std::errc::invalid_argument ||
+      read_error<model::point>(R"({"z":"\q"})") !=
+          std::errc::invalid_argument ||
+      read_error<model::point>(R"({"z":[1,}})") !=
+          std::errc::invalid_argument ||
+      read_error<std::variant<int, bool>>("[2,1]") !=
+          std::errc::invalid_argument ||
+      read_error<std::string>("\"unterminated") !=
+          std::errc::invalid_argument ||
+      read_error<std::string>("\"\\ud83d\"") !=
+          std::errc::invalid_argument ||
+      read_error<std::string>("\"\\udc00\"") !=
+          std::errc::invalid_argument) {
+    return 1;
+  }
+
+  // Writing stops at the first error, even if what follows would fit
+  char small[6];
+  const auto [stop, stop_ec] = dpsg::json::write(
+      small, small + sizeof(small), std::tuple{123456789, 1});
+  if (stop_ec != std::errc::value_too_large || stop != small + 1) {
+    return 1;
+  }
+
+  return 0;
+}
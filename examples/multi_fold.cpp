@@ -0,0 +1,202 @@
+#include <composite.hpp>
+#include <fold.hpp>
+#include <multi_fold.hpp>
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Several reductions computed in a single traversal, returned as a tuple.
+
+namespace r = dpsg::reductions;
+
+// Tuples: every accumulator follows the elements, whatever their types
+constexpr auto tuple_stats = dpsg::multi_fold(std::tuple{3, 1.5, 2L},
+                                              r::count(),
+                                              r::sum(0.0),
+                                              r::minimum(100.0),
+                                              r::maximum(0.0));
+static_assert(std::get<0>(tuple_stats) == 3);
+static_assert(std::get<1>(tuple_stats) == 6.5);
+static_assert(std::get<2>(tuple_stats) == 1.5);
+static_assert(std::get<3>(tuple_stats) == 3.0);
+
+// An accumulator may change type along a tuple, as with dpsg::fold
+constexpr auto widen = [](auto acc, auto element) { return acc + element; };
+constexpr auto mixed =
+    dpsg::multi_fold(std::tuple{1, 2L, 3LL}, dpsg::reduce(0, widen));
+static_assert(
+    std::is_same_v<std::remove_cv_t<decltype(mixed)>, std::tuple<long long>>);
+static_assert(std::get<0>(mixed) == 6);
+
+// A single accumulator may itself be a pair or a tuple, it stays wrapped
+constexpr auto min_max = [](std::pair<int, int> acc, int i) {
+  return std::pair{i < acc.first ? i : acc.first,
+                   acc.second < i ? i : acc.second};
+};
+constexpr auto merge_min_max = [](std::pair<int, int> l,
+                                  std::pair<int, int> r) {
+  return min_max(min_max(l, r.first), r.second);
+};
+constexpr auto bounds = dpsg::multi_fold(
+    std::tuple{3, 1, 2}, dpsg::reduce(std::pair{100, -100}, min_max));
+static_assert(std::is_same_v<std::remove_cv_t<decltype(bounds)>,
+                             std::tuple<std::pair<int, int>>>);
+static_assert(std::get<0>(bounds) == std::pair{1, 3});
+constexpr std::array<int, 11> spread{5, -3, 8, 0, 12, 7, -9, 4, 1, 2, 6};
+static_assert(
+    dpsg::multi_fold(spread,
+                     dpsg::reduce(std::pair{100, -100},
+                                  min_max,
+                                  merge_min_max,
+                                  std::pair{100, -100})) ==
+    std::tuple<std::pair<int, int>>{{-9, 12}});
+
+// Reductions of the same type are kept apart
+constexpr std::array<int, 7> numbers{4, 8, 15, 16, 23, 42, 1};
+constexpr auto odd_even = dpsg::multi_fold(
+    numbers,
+    dpsg::reduce(0, [](int acc, int i) { return acc + i % 2; }),
+    dpsg::reduce(0, [](int acc, int i) { return acc + (i + 1) % 2; }));
+static_assert(odd_even == std::tuple{3, 4});
+
+// Splittable reductions over a contiguous range take the lane path, whose
+// result is the same for sizes that aren't multiples of the lane count
+constexpr auto array_stats = dpsg::multi_fold(numbers,
+                                              r::count<int>(),
+                                              r::sum<int>(),
+                                              r::minimum(1000),
+                                              r::maximum(-1000));
+static_assert(array_stats == std::tuple{7, 109, 1, 42});
+
+// Composites: every node goes through every reduction, in pre-order
+namespace doc {
+using dpsg::composite;
+
+template <class... Args>
+struct section : composite<Args...> {
+  template <class... Args2>
+  constexpr explicit section(Args2&&... args)
+      : composite<Args...>{std::forward<Args2>(args)...} {}
+};
+template <class... Args>
+section(Args&&...) -> section<Args...>;
+
+struct paragraph : composite<> {
+  constexpr explicit paragraph(int words) noexcept : words{words} {}
+  int words;
+};
+}  // namespace doc
+
+constexpr doc::section document{
+    doc::paragraph{12},
+    doc::section{doc::paragraph{30}, doc::paragraph{7}},
+    doc::paragraph{5}};
+
+constexpr auto count_words = [](int acc, const auto& node) {
+  if constexpr (std::is_same_v<std::decay_t<decltype(node)>, doc::paragraph>) {
+    return acc + node.words;
+  }
+  else {
+    return acc;
+  }
+};
+constexpr auto count_sections = [](int acc, const auto& node) {
+  return acc + static_cast<int>(!std::is_same_v<std::decay_t<decltype(node)>,
+                                                doc::paragraph>);
+};
+constexpr auto document_stats =
+    dpsg::multi_fold(document,
+                     dpsg::reduce(0, count_words),
+                     dpsg::reduce(0, count_sections),
+                     dpsg::reduce(0, [](int acc, const auto&) {
+                       return acc + 1;
+                     }));
+static_assert(document_stats == std::tuple{54, 2, 6});
+
+int main() {
+  // Ranges: the results match separate folds, with and without lanes
+  for (std::size_t size : {0, 1, 7, 8, 9, 31, 1000}) {
+    std::vector<int> values(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      values[i] = static_cast<int>((i * 7919) % 1013) - 500;
+    }
+    constexpr int high = std::numeric_limits<int>::max();
+    constexpr int low = std::numeric_limits<int>::min();
+    const auto expected = std::tuple{
+        dpsg::fold(values, std::size_t{0}, [](std::size_t acc, int) {
+          return acc + 1;
+        }),
+        dpsg::fold(values, 0LL, std::plus<>{}),
+        dpsg::fold(values, high, [](int acc, int i) {
+          return i < acc ? i : acc;
+        }),
+        dpsg::fold(values, low, [](int acc, int i) {
+          return acc < i ? i : acc;
+        })};
+
+    const auto split = dpsg::multi_fold(values,
+                                        r::count(),
+                                        r::sum(0LL),
+                                        r::minimum(high),
+                                        r::maximum(low));
+    if (split != expected) {
+      std::cerr << "lane fold differs for " << size << " elements\n";
+      return 1;
+    }
+
+    // Without a combiner, the elements are folded in order
+    const auto sequential = dpsg::multi_fold(
+        values,
+        dpsg::reduce(std::size_t{0},
+                     [](std::size_t acc, int) { return acc + 1; }),
+        dpsg::reduce(0LL, [](long long acc, int i) { return acc + i; }),
+        r::minimum(high),
+        r::maximum(low));
+    if (sequential != expected) {
+      std::cerr << "sequential fold differs for " << size << " elements\n";
+      return 1;
+    }
+
+    // Non contiguous ranges are folded in order too
+    const std::list<int> linked(values.begin(), values.end());
+    if (dpsg::multi_fold(linked,
+                         r::count(),
+                         r::sum(0LL),
+                         r::minimum(high),
+                         r::maximum(low)) != expected) {
+      std::cerr << "list fold differs for " << size << " elements\n";
+      return 1;
+    }
+  }
+
+  // Reductions in order see the elements in order
+  const std::vector<std::string> words{"one", "pass", "only"};
+  const auto [joined, letters] = dpsg::multi_fold(
+      words,
+      dpsg::reduce(std::string{},
+                   [](std::string acc, const std::string& word) {
+                     return acc.empty() ? word : acc + ' ' + word;
+                   }),
+      dpsg::reduce(std::size_t{0},
+                   [](std::size_t acc, const std::string& word) {
+                     return acc + word.size();
+                   }));
+  if (joined != "one pass only" || letters != 11) {
+    std::cerr << "unexpected result: " << joined << ", " << letters << '\n';
+    return 1;
+  }
+
+  const auto [count, sum, min, max] = array_stats;
+  std::cout << "count " << count << ", sum " << sum << ", min " << min
+            << ", max " << max << '\n';
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include <composite.hpp>
+#include <only.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+// dpsg::traverse_only and dpsg::fold_only visit the elements of a given type
+// wherever they are in a structure, and skip the subtrees that can't contain
+// any of them. Which subtrees those are is known at compile time.
+
+namespace scene {
+using dpsg::composite;
+
+struct mesh : composite<> {
+  constexpr explicit mesh(int triangles) noexcept : triangles{triangles} {}
+  int triangles;
+};
+
+struct light : composite<> {
+  constexpr explicit light(float intensity) noexcept : intensity{intensity} {}
+  float intensity;
+};
+
+template <class... Args>
+struct node : composite<Args...> {
+  template <class... Args2>
+  constexpr explicit node(Args2&&... args)
+      : composite<Args...>{std::forward<Args2>(args)...} {}
+};
+template <class... Args>
+node(Args&&...) -> node<Args...>;
+
+// Only lights in there
+template <class... Args>
+struct rig : node<Args...> {
+  using node<Args...>::node;
+};
+template <class... Args>
+rig(Args&&...) -> rig<Args...>;
+}  // namespace scene
+
+constexpr scene::node world{
+    scene::node{scene::mesh{12}, scene::light{0.5f}, scene::mesh{30}},
+    scene::rig{scene::light{1.f}, scene::light{2.f}},
+    scene::node{scene::node{scene::mesh{100}}}};
+
+// The rig can't contain meshes, it will never be walked when looking for them
+static_assert(dpsg::may_contain_v<decltype(world), scene::mesh>);
+static_assert(!dpsg::may_contain_v<scene::rig<scene::light, scene::light>,
+                                   scene::mesh>);
+static_assert(dpsg::may_contain_v<std::tuple<int, std::optional<char>>, char>);
+static_assert(!dpsg::may_contain_v<std::tuple<int, std::vector<int>>, char>);
+static_assert(dpsg::may_contain_v<std::variant<int, std::vector<char>>, char>);
+
+constexpr int count_triangles() {
+  int triangles = 0;
+  dpsg::traverse_only<scene::mesh>(world, [&triangles](const scene::mesh& m) {
+    triangles += m.triangles;
+  });
+  return triangles;
+}
+static_assert(count_triangles() == 142);
+
+constexpr auto add_intensity = [](float acc, const scene::light& l) {
+  return acc + l.intensity;
+};
+static_assert(dpsg::fold_only<scene::light>(world, 0.f, add_intensity) ==
+              3.5f);
+
+// Several types may be selected at once
+static_assert(dpsg::fold_only<scene::light, scene::mesh>(
+                  world, 0, [](int acc, const auto&) { return acc + 1; }) == 6);
+
+// Works on any mix of standard types
+static_assert(dpsg::fold_only<char>(
+                  std::tuple{1, 'a', std::pair{2.0, 'b'}, std::optional{'c'}},
+                  0,
+                  [](int acc, char c) { return acc + (c - 'a' + 1); }) == 6);
+
+// Text is a leaf: it is selected as a whole, never character by character
+static_assert(!dpsg::may_contain_v<std::string_view, char>);
+static_assert(dpsg::may_contain_v<std::tuple<std::string_view, char>, char>);
+static_assert(dpsg::fold_only<char>(
+                  std::tuple<std::string_view, char>{"abc", 'x'},
+                  0,
+                  [](int acc, char) { return acc + 1; }) == 1);
+static_assert(dpsg::fold_only<std::string_view>(
+                  std::tuple<std::string_view, char>{"abc", 'x'},
+                  std::size_t{0},
+                  [](std::size_t acc, std::string_view s) {
+                    return acc + s.size();
+                  }) == 3);
+
+// A range that counts how many times it is walked
+struct counting_range {
+  int* walks;
+  const int* begin() const {
+    ++*walks;
+    return nullptr;
+  }
+  const int* end() const { return nullptr; }
+};
+
+int main() {
+  int walks = 0;
+  std::tuple<char, counting_range, std::vector<char>> data{
+      'x', counting_range{&walks}, std::vector<char>{'y', 'z'}};
+
+  std::string found;
+  dpsg::traverse_only<char>(data, [&found](char c) { found += c; });
+  if (found != "xyz" || walks != 0) {
+    return 1;
+  }
+
+  dpsg::traverse_only<int>(data, [](int) {});
+  if (walks != 1) {
+    return 1;
+  }
+
+  std::string characters;
+  dpsg::traverse_only<char>(std::tuple<std::string, char>{"abc", 'x'},
+                            [&characters](char c) { characters += c; });
+  if (characters != "x") {
+    return 1;
+  }
+
+  // Extra arguments are given to the visitor
+  int lights = 0;
+  dpsg::traverse_only<scene::light>(
+      world, [](const scene::light&, int& count) { ++count; }, lights);
+  return lights == 3 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include <fold.hpp>
+#include <pipeline.hpp>
+#include <traverse.hpp>
+
+#include <array>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Lazy filter and transform stages, merged into the visitor given to the
+// source: one pass, no intermediate container.
+
+constexpr auto is_odd = [](int i) { return i % 2 != 0; };
+constexpr auto square = [](int i) { return i * i; };
+
+// Fixed arrays and tuples can be folded through a pipeline at compile time
+constexpr std::array<int, 6> numbers{1, 2, 3, 4, 5, 6};
+static_assert(dpsg::fold(numbers | dpsg::filter(is_odd) |
+                             dpsg::transform(square),
+                         0,
+                         std::plus<>{}) == 1 + 9 + 25);
+static_assert(dpsg::fold(std::tuple{1, 2L, 3LL} | dpsg::transform(square),
+                         0LL,
+                         std::plus<>{}) == 1 + 4 + 9);
+
+// Stages compose from left to right
+static_assert(dpsg::fold(numbers | dpsg::transform(square) |
+                             dpsg::filter([](int i) { return i > 10; }),
+                         0,
+                         std::plus<>{}) == 16 + 25 + 36);
+
+// Views reference lvalues, and stateless stages take no room
+using view_t = decltype(numbers | dpsg::filter(is_odd) |
+                        dpsg::transform(square));
+static_assert(sizeof(view_t) == sizeof(const std::array<int, 6>*));
+static_assert(dpsg::is_traversable_v<view_t>);
+static_assert(dpsg::is_foldable_v<view_t, int>);
+
+// Counts the copies of the elements, to check that nothing is materialized
+struct tracked {
+  int value;
+  static inline int copies = 0;
+  explicit tracked(int v) : value{v} {}
+  tracked(const tracked& other) : value{other.value} { ++copies; }
+  tracked& operator=(const tracked& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+};
+
+int main() {
+  std::vector<int> values{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  auto squares_of_odds = values | dpsg::filter(is_odd) |
+                         dpsg::transform(square);
+
+  long long sum = dpsg::fold(squares_of_odds, 0LL, std::plus<>{});
+  std::cout << "sum of the squares of odd numbers: " << sum << "\n";
+  if (sum != 1 + 9 + 25 + 49 + 81) {
+    return 1;
+  }
+
+  // The view is lazy: it sees later changes to its source
+  values.push_back(11);
+  if (dpsg::fold(squares_of_odds, 0LL, std::plus<>{}) != sum + 121) {
+    return 1;
+  }
+
+  // Traversal, with extra arguments going to the final visitor
+  std::string out;
+  dpsg::traverse(
+      squares_of_odds,
+      [](int i, std::string& s) { s += std::to_string(i) + " "; },
+      out);
+  std::cout << out << "\n";
+  if (out != "1 9 25 49 81 121 ") {
+    return 1;
+  }
+
+  // Elements reach the visitor by reference when no stage transforms them
+  dpsg::traverse(values | dpsg::filter(is_odd), [](int& i) { i = 0; });
+  if (dpsg::fold(values, 0, std::plus<>{}) != 2 + 4 + 6 + 8 + 10) {
+    return 1;
+  }
+
+  // Rvalue sources are owned by the view
+  auto owned = std::vector<int>{3, 4, 5} | dpsg::transform(square);
+  if (dpsg::fold(owned, 0, std::plus<>{}) != 9 + 16 + 25) {
+    return 1;
+  }
+
+  // Heterogeneous tuples go through the same pipeline
+  std::string described;
+  dpsg::traverse(std::tuple{1, 2.5, std::string{"three"}} |
+                     dpsg::transform([](const auto& v) {
+                       if constexpr (std::is_same_v<
+                                         std::decay_t<decltype(v)>,
+                                         std::string>) {
+                         return v;
+                       }
+                       else {
+                         return std::to_string(v);
+                       }
+                     }) |
+                     dpsg::filter([](const std::string& s) {
+                       return s.size() > 1;
+                     }),
+                 [&described](const std::string& s) { described += s; });
+  if (described != "2.500000three") {
+    return 1;
+  }
+
+  // No element is copied on the way to the visitor
+  std::vector<tracked> objects{tracked{1}, tracked{2}, tracked{3}};
+  tracked::copies = 0;
+  int total = 0;
+  dpsg::traverse(objects | dpsg::filter([](const tracked& t) {
+                   return t.value != 2;
+                 }) | dpsg::transform([](const tracked& t) -> const int& {
+                   return t.value;
+                 }),
+                 [&total](const int& i) { total += i; });
+  if (total != 4 || tracked::copies != 0) {
+    return 1;
+  }
+}
@@ -0,0 +1,120 @@
+#include <fold.hpp>
+#include <prefetch.hpp>
+#include <traverse.hpp>
+
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+// dpsg::prefetched wraps a range to visit it while prefetching the elements
+// ahead of the current one. It changes nothing to the order or the values
+// seen by the visitor, only to the memory access pattern.
+
+namespace intrusive {
+// A minimal intrusive singly linked list, the kind of structure prefetching
+// is meant for
+struct node {
+  int value;
+  node* next;
+};
+
+struct iterator {
+  node* current;
+
+  node& operator*() const { return *current; }
+  iterator& operator++() {
+    current = current->next;
+    return *this;
+  }
+  friend bool operator==(iterator l, iterator r) {
+    return l.current == r.current;
+  }
+  friend bool operator!=(iterator l, iterator r) { return !(l == r); }
+};
+
+struct list {
+  node* head;
+};
+iterator begin(const list& l) {
+  return {l.head};
+}
+iterator end(const list&) {
+  return {nullptr};
+}
+}  // namespace intrusive
+
+template <class R, class... Args>
+bool same_sequence(R&& range, Args&&... prefetch_args) {
+  std::vector<const void*> plain;
+  std::vector<const void*> prefetched;
+  dpsg::traverse(range, [&plain](const auto& e) { plain.push_back(&e); });
+  dpsg::traverse(dpsg::prefetched(range, prefetch_args...),
+                 [&prefetched](const auto& e) { prefetched.push_back(&e); });
+  return plain == prefetched;
+}
+
+int main() {
+  std::map<int, std::unique_ptr<int>> map;
+  std::set<int> set;
+  std::list<int> list;
+  for (int i = 0; i < 100; ++i) {
+    map.emplace((i * 37) % 100, std::make_unique<int>(i));
+    set.insert((i * 13) % 100);
+    list.push_back(i);
+  }
+
+  std::vector<intrusive::node> nodes(10);
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    nodes[i] = {static_cast<int>(i),
+                i + 1 < nodes.size() ? &nodes[i + 1] : nullptr};
+  }
+  intrusive::list ilist{nodes.data()};
+
+  static_assert(dpsg::is_traversable_v<decltype(dpsg::prefetched(map))>);
+  static_assert(dpsg::is_foldable_v<decltype(dpsg::prefetched(map)), int>);
+
+  if (!same_sequence(map) || !same_sequence(set) || !same_sequence(list) ||
+      !same_sequence(ilist)) {
+    return 1;
+  }
+  // Distances of 0 or larger than the range are fine
+  if (!same_sequence(list, 0) || !same_sequence(list, 1000) ||
+      !same_sequence(ilist, 3)) {
+    return 1;
+  }
+  // The projection may point to data owned by the element
+  if (!same_sequence(map, 4, [](const auto& kv) { return kv.second.get(); })) {
+    return 1;
+  }
+  // Or return several addresses
+  if (!same_sequence(map, 4, [](const auto& kv) {
+        return std::array<const void*, 2>{&kv, kv.second.get()};
+      })) {
+    return 1;
+  }
+
+  constexpr auto sum = [](int acc, const auto& kv) {
+    return acc + *kv.second;
+  };
+  int expected = dpsg::fold(map, 0, sum);
+  int result = dpsg::fold(dpsg::prefetched(map, 16), 0, sum);
+  if (result != expected || result != 4950) {
+    return 1;
+  }
+
+  // Extra arguments are forwarded to the visitor as usual
+  int total = 0;
+  dpsg::traverse(
+      dpsg::prefetched(ilist, 2),
+      [](const intrusive::node& n, int& out) { out += n.value; },
+      total);
+  if (total != 45) {
+    return 1;
+  }
+
+  std::cout << "sum of the payloads: " << result << std::endl;
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include <composite.hpp>
+#include <propagation.hpp>
+
+#include <functional>
+#include <iostream>
+#include <vector>
+
+// dpsg::propagation_cache computes state derived from the parents in a
+// hierarchy (world positions from relative offsets here) and keeps it up to
+// date when some of the nodes change.
+
+namespace robot {
+// A static hierarchy, each part is placed relative to its parent
+template <class... Parts>
+struct part : dpsg::composite<Parts...> {
+  template <class... Args>
+  constexpr explicit part(int offset, Args&&... args)
+      : dpsg::composite<Parts...>{std::forward<Args>(args)...},
+        offset{offset} {}
+  int offset;
+};
+template <class... Args>
+part(int, Args&&...) -> part<Args...>;
+}  // namespace robot
+
+namespace scene {
+// A runtime hierarchy
+struct node {
+  int offset;
+  std::vector<node> children;
+};
+}  // namespace scene
+
+int main() {
+  using positions = dpsg::propagation_cache<int, int, std::plus<>>;
+  const auto offset = [](const auto& part) { return part.offset; };
+
+  // body(100) { arm(10) { hand(1) }, arm(20) { hand(2) } }
+  const robot::part body{
+      100,
+      robot::part{10, robot::part{1}},
+      robot::part{20, robot::part{2}}};
+  positions robot_positions;
+  robot_positions.assign(body, offset);
+  if (robot_positions.update() != 5) {
+    return 1;
+  }
+  // Nodes are numbered in pre-order
+  const std::vector<int> expected_robot{100, 110, 111, 120, 122};
+  for (std::size_t i = 0; i < expected_robot.size(); ++i) {
+    if (robot_positions.derived(i) != expected_robot[i]) {
+      return 1;
+    }
+  }
+
+  // Only the changed nodes and their descendants are recomputed
+  robot_positions.set_local(1, 30);
+  if (robot_positions.update() != 2 || robot_positions.derived(1) != 130 ||
+      robot_positions.derived(2) != 131 || robot_positions.derived(4) != 122) {
+    return 1;
+  }
+  if (robot_positions.update() != 0) {
+    return 1;
+  }
+  // Nested dirty nodes are covered by the sweep of their ancestor
+  robot_positions.set_local(2, 5);
+  robot_positions.set_local(0, 0);
+  robot_positions.set_local(4, 4);
+  if (robot_positions.update() != 5 || robot_positions.derived(2) != 35 ||
+      robot_positions.derived(4) != 24) {
+    return 1;
+  }
+
+  // Runtime trees are walked with dpsg::walk
+  const scene::node root{
+      1, {{2, {{3, {}}, {4, {}}}}, {5, {}}, {6, {{7, {{8, {}}}}}}}};
+  positions scene_positions{1000};
+  scene_positions.assign(root, offset);
+  scene_positions.update();
+  const std::vector<int> expected_scene{
+      1001, 1003, 1006, 1007, 1006, 1007, 1014, 1022};
+  for (std::size_t i = 0; i < expected_scene.size(); ++i) {
+    std::cout << scene_positions.derived(i) << ' ';
+    if (scene_positions.derived(i) != expected_scene[i] ||
+        (i > 0 && scene_positions.parent(i) >= i)) {
+      return 1;
+    }
+  }
+  std::cout << '\n';
+  scene_positions.set_local(5, 0);
+  if (scene_positions.update() != 3 || scene_positions.derived(7) != 1016) {
+    return 1;
+  }
+
+  // Changing the state of the roots recomputes everything
+  scene_positions.set_root_state(0);
+  if (scene_positions.update() != 8 || scene_positions.derived(0) != 1) {
+    return 1;
+  }
+
+  // Nodes can be added by hand, in pre-order
+  positions manual{0};
+  const auto top = manual.push(positions::no_parent, 1);
+  const auto child = manual.push(top, 2);
+  manual.push(child, 3);
+  manual.push(positions::no_parent, 4);
+  manual.update();
+  if (manual.derived(2) != 6 || manual.derived(3) != 4) {
+    return 1;
+  }
+  manual.set_local(top, 10);
+  if (manual.update() != 3 || manual.derived(3) != 4) {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include <compressed_tuple.hpp>
+#include <scan.hpp>
+
+#include <array>
+#include <functional>
+#include <list>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// dpsg::fold_right folds from the last element to the first, and the scans
+// give every intermediate result of a fold.
+
+constexpr auto append = [](std::string acc, const auto& element) {
+  return acc + element;
+};
+
+// Right folds
+static_assert(dpsg::fold_right(std::tuple{1, 2, 3}, 0, [](int acc, int i) {
+                return acc * 10 + i;
+              }) == 321);
+static_assert(dpsg::fold_right(std::array{1, 2, 3}, 0, [](int acc, int i) {
+                return acc * 10 + i;
+              }) == 321);
+static_assert(dpsg::fold_right(std::optional<int>{4}, 1, std::plus<>{}) == 5);
+
+// Compressed tuples are tuples too
+constexpr dpsg::compressed_tuple<char, int, long> packed{'\1', 2, 3L};
+static_assert(dpsg::fold_right(packed, 0, [](int acc, int i) {
+                return acc * 10 + i;
+              }) == 321);
+static_assert(dpsg::inclusive_scan(packed, 0, std::plus<>{}) ==
+              std::tuple{1, 3, 6});
+
+// Scans over tuples are computed at compile time, and the accumulator may
+// change type along the way
+constexpr auto sums =
+    dpsg::inclusive_scan(std::tuple{1, 2.5, 3}, 0, std::plus<>{});
+static_assert(std::is_same_v<std::decay_t<decltype(sums)>,
+                             std::tuple<int, double, double>>);
+static_assert(sums == std::tuple{1, 3.5, 6.5});
+static_assert(dpsg::exclusive_scan(std::pair{1, 2}, 10, std::plus<>{}) ==
+              std::tuple{10, 11});
+static_assert(dpsg::exclusive_scan(std::tuple{}, 0, std::plus<>{}) ==
+              std::tuple{});
+static_assert(dpsg::inclusive_scan(std::array{1, 2, 3}, 0, std::plus<>{}) ==
+              std::array{1, 3, 6});
+static_assert(dpsg::exclusive_scan(std::array{1, 2, 3}, 0, std::plus<>{}) ==
+              std::array{0, 1, 3});
+
+// Extra arguments are given to every call, as with dpsg::fold
+static_assert(dpsg::inclusive_scan(
+                  std::tuple{1, 2},
+                  0,
+                  [](int acc, int i, int factor) { return acc + i * factor; },
+                  10) == std::tuple{10, 30});
+
+int main() {
+  const std::list<std::string> words{"a", "b", "c"};
+  if (dpsg::fold_right(words, std::string{}, append) != "cba" ||
+      dpsg::inclusive_scan(words, std::string{}, append) !=
+          std::vector<std::string>{"a", "ab", "abc"} ||
+      dpsg::exclusive_scan(words, std::string{">"}, append) !=
+          std::vector<std::string>{">", ">a", ">ab"}) {
+    return 1;
+  }
+
+  // Running offsets of a batch of sizes
+  const std::vector<std::size_t> sizes{3, 1, 4, 1, 5};
+  if (dpsg::exclusive_scan(sizes, std::size_t{0}, std::plus<>{}) !=
+      std::vector<std::size_t>{0, 3, 4, 8, 9}) {
+    return 1;
+  }
+
+  // The parallel scans agree with the sequential ones
+  std::vector<long long> values(1 << 20);
+  std::iota(values.begin(), values.end(), 1);
+  std::vector<long long> parallel(values.size());
+  const auto expected_inclusive =
+      dpsg::inclusive_scan(values, 5LL, std::plus<>{});
+  const auto expected_exclusive =
+      dpsg::exclusive_scan(values, 5LL, std::plus<>{});
+  for (std::size_t threads : {0, 1, 3, 8, 64}) {
+    auto end = dpsg::parallel_inclusive_scan(
+        values, parallel.begin(), 5LL, std::plus<>{}, threads);
+    if (end != parallel.end() || parallel != expected_inclusive) {
+      return 1;
+    }
+    dpsg::parallel_exclusive_scan(
+        values, parallel.begin(), 5LL, std::plus<>{}, threads);
+    if (parallel != expected_exclusive) {
+      return 1;
+    }
+  }
+
+  // Small inputs are scanned sequentially, into any random access iterator
+  const std::array<int, 4> few{1, 2, 3, 4};
+  int out[4];
+  dpsg::parallel_inclusive_scan(few, out, 0, std::plus<>{});
+  if (out[3] != 10) {
+    return 1;
+  }
+
+  // Exceptions are rethrown in the calling thread
+  const auto last = static_cast<long long>(values.size());
+  try {
+    dpsg::parallel_inclusive_scan(
+        values,
+        parallel.begin(),
+        0LL,
+        [last](long long acc, long long v) {
+          if (v == last) {
+            throw std::runtime_error{"last element"};
+          }
+          return acc + v;
+        },
+        4);
+    return 1;
+  }
+  catch (const std::runtime_error&) {
+  }
+
+  return 0;
+}
@@ -1,6 +1,8 @@
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "traverse.hpp"
 
@@ -64,6 +66,20 @@ int main() {
   std::cout << "optional (with value):\n";
   dpsg::traverse(make_const(i1), print);
 
+  std::cout << std::endl;
+
+  // Anything that can be iterated over with a range-based for loop is
+  // traversable, elements are always given as lvalues
+  std::cout << "ranges\n=========\n";
+  std::cout << "vector:\n";
+  dpsg::traverse(std::vector<int>{1, 2, 3}, print);
+  std::cout << "map:\n";
+  dpsg::traverse(std::map<int, char>{{1, 'a'}, {2, 'b'}},
+                 [](const auto& kv) {
+                   std::cout << "value contained: " << kv.first << " -> "
+                             << kv.second << "\n";
+                 });
+
   std::cout << "done" << std::endl;
 
   return 0;
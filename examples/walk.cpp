@@ -0,0 +1,170 @@
+#include <walk.hpp>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+// dpsg::walk and dpsg::tree_walker traverse recursive runtime structures
+// without recursion. This file walks a small variant-based document in the 3
+// supported orders, then a tree far too deep for a recursive traversal.
+
+namespace doc {
+struct text {
+  std::string content;
+};
+struct section;
+using node = std::variant<text, section>;
+struct section {
+  std::string title;
+  std::vector<node> children;
+};
+
+// The children of a section are found through its `children` member, text
+// nodes have none
+}  // namespace doc
+
+namespace deep {
+// Children given as pointers, the tree itself lives in a vector
+struct node {
+  int value;
+  std::vector<node*> children;
+};
+
+// Or explicitly through dpsg_children
+struct binary {
+  int value;
+  std::unique_ptr<binary> left;
+  std::unique_ptr<binary> right;
+};
+
+template <class F>
+void dpsg_children(const binary& b, F&& push) {
+  push(b.left);
+  push(b.right);
+}
+}  // namespace deep
+
+std::string name(const doc::node& n) {
+  return std::visit(
+      [](const auto& v) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(v)>, doc::text>) {
+          return v.content;
+        }
+        else {
+          return v.title;
+        }
+      },
+      n);
+}
+
+int main() {
+  const doc::node document = doc::section{
+      "root",
+      {doc::section{"a", {doc::text{"a1"}, doc::text{"a2"}}},
+       doc::text{"b"},
+       doc::section{"c", {doc::section{"c1", {doc::text{"c11"}}}}}}};
+
+  std::string pre;
+  dpsg::walk(dpsg::pre_order,
+             document,
+             [&pre](const doc::node& n, auto next, int depth) {
+               pre += std::to_string(depth) + name(n) + " ";
+               next(depth + 1);
+             },
+             0);
+  std::cout << "pre-order:     " << pre << "\n";
+  if (pre != "0root 1a 2a1 2a2 1b 1c 2c1 3c11 ") {
+    return 1;
+  }
+
+  std::string post;
+  dpsg::walk(dpsg::post_order, document, [&post](const doc::node& n, auto) {
+    post += name(n) + " ";
+  });
+  std::cout << "post-order:    " << post << "\n";
+  if (post != "a1 a2 a b c11 c1 c root ") {
+    return 1;
+  }
+
+  std::string breadth;
+  dpsg::walk(dpsg::breadth_first,
+             document,
+             [&breadth](const doc::node& n, auto next) {
+               breadth += name(n) + " ";
+               next();
+             });
+  std::cout << "breadth first: " << breadth << "\n";
+  if (breadth != "root a b c a1 a2 c1 c11 ") {
+    return 1;
+  }
+
+  // Not calling next prunes the subtree
+  std::string pruned;
+  dpsg::walk(dpsg::pre_order,
+             document,
+             [&pruned](const doc::node& n, auto next) {
+               pruned += name(n) + " ";
+               if (name(n) != "a") {
+                 next();
+               }
+             });
+  if (pruned != "root a b c c1 c11 ") {
+    return 1;
+  }
+
+  // A reusable walker keeps its storage from one walk to the next
+  dpsg::tree_walker<const doc::node> walker{16};
+  int count = 0;
+  const auto counter = [&count](const doc::node&, auto next) {
+    ++count;
+    next();
+  };
+  walker(dpsg::pre_order, document, counter);
+  walker(dpsg::breadth_first, document, counter);
+  walker(dpsg::post_order, document, counter);
+  if (count != 24 || walker.capacity() < 16) {
+    return 1;
+  }
+
+  // A million nodes deep, in each order
+  constexpr int depth = 1'000'000;
+  std::vector<deep::node> chain(depth);
+  for (int i = 0; i < depth; ++i) {
+    chain[i].value = i;
+    if (i + 1 < depth) {
+      chain[i].children.push_back(&chain[i + 1]);
+    }
+  }
+  long long sum = 0;
+  const auto add = [&sum](const deep::node& n, auto next) {
+    sum += n.value;
+    next();
+  };
+  dpsg::walk(dpsg::pre_order, chain[0], add);
+  dpsg::walk(dpsg::post_order, chain[0], add);
+  dpsg::walk(dpsg::breadth_first, chain[0], add);
+  if (sum != 3 * (static_cast<long long>(depth) * (depth - 1) / 2)) {
+    return 1;
+  }
+
+  const auto leaf = [](int value) {
+    return std::make_unique<deep::binary>(
+        deep::binary{value, nullptr, nullptr});
+  };
+  deep::binary tree{1, leaf(2), leaf(3)};
+  tree.right->left = leaf(4);
+  std::string binary;
+  dpsg::walk(dpsg::pre_order,
+             tree,
+             [&binary](const deep::binary& b, auto next) {
+               binary += std::to_string(b.value);
+               next();
+             });
+  if (binary != "1234") {
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,290 @@
+#ifndef GUARD_DPSG_ANY_TRAVERSABLE_HPP
+#define GUARD_DPSG_ANY_TRAVERSABLE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./traverse.hpp"
+
+/* template<class T> class visitor_ref;
+   template<class T, std::size_t Size> class any_traversable;
+
+    Type erasure for traversables, to pass "something traversable" across
+   library or plugin boundaries without templating everything.
+
+    visitor_ref<T> is a non-owning reference to any callable accepting a T.
+   It is two pointers wide and calling it costs a single indirect call.
+
+    any_traversable<T> owns a copy of any traversable object whose elements are
+   all convertible to T. Objects up to Size bytes (4 pointers by default) that
+   can be moved without throwing are stored inline, larger ones on the heap.
+   Traversing the handle runs the fully templated dpsg::traverse of the stored
+   object, which hands every element to the visitor through a visitor_ref:
+   the cost is one indirect call per element.
+
+        void print_all(dpsg::any_traversable<const int&> values) {
+          dpsg::traverse(values, [](int i) { std::cout << i << '\n'; });
+        }
+
+        print_all(std::vector<int>{1, 2, 3});
+        print_all(std::tuple<int, short, char>{4, 5, 6});
+
+    When T is a non-const lvalue reference, elements are modifiable and only
+   non-const handles are traversable. Otherwise the stored object is
+   traversed as const. Extra arguments given to dpsg::traverse are forwarded
+   to the visitor as usual, but on the caller side of the erasure.
+*/
+
+namespace dpsg {
+
+namespace detail {
+
+template <class T, class U, std::size_t... Is>
+constexpr bool tuple_elements_convert(
+    [[maybe_unused]] std::index_sequence<Is...> marker) noexcept {
+  return (
+      std::is_convertible_v<decltype(tuple_get<Is>(std::declval<U&>())), T> &&
+      ...);
+}
+
+// Whether the elements given out by a traversal of U convert to T, as far as
+// its type tells: one by one for tuples and pairs, through the element type
+// for arrays and the reference type for ranges traversed with a loop. Other
+// customizations don't say what they give out and are assumed to comply.
+template <class T, class U>
+constexpr bool elements_convert() noexcept {
+  if constexpr (is_fixed_size_array_v<U>) {
+    return std::is_convertible_v<decltype(std::declval<U&>()[0]), T>;
+  }
+  else if constexpr (is_tuple_v<U> ||
+                     is_template_instance_v<std::remove_cv_t<U>, std::pair>) {
+    return tuple_elements_convert<T, U>(
+        std::make_index_sequence<std::tuple_size_v<std::remove_cv_t<U>>>{});
+  }
+  else if constexpr (is_loop_traversable_v<U&>) {
+    return std::is_convertible_v<decltype(*adl_begin(std::declval<U&>())), T>;
+  }
+  else {
+    return true;
+  }
+}
+
+}  // namespace detail
+
+template <class T>
+class visitor_ref {
+ public:
+  template <class F,
+            std::enable_if_t<
+                !std::is_same_v<std::decay_t<F>, visitor_ref> &&
+                    std::is_invocable_v<std::remove_reference_t<F>&, T>,
+                int> = 0>
+  constexpr visitor_ref(F&& f) noexcept
+      : object_{const_cast<void*>(static_cast<const void*>(std::addressof(f)))},
+        call_{&call<std::remove_reference_t<F>>} {}
+
+  void operator()(T value) const { call_(object_, std::forward<T>(value)); }
+
+ private:
+  template <class F>
+  static void call(void* object, T value) {
+    (*static_cast<F*>(object))(std::forward<T>(value));
+  }
+
+  void* object_;
+  void (*call_)(void*, T);
+};
+
+template <class T, std::size_t Size = 4 * sizeof(void*)>
+class any_traversable {
+  constexpr static inline bool mutable_traversal =
+      std::is_lvalue_reference_v<T> &&
+      !std::is_const_v<std::remove_reference_t<T>>;
+  using object_pointer =
+      std::conditional_t<mutable_traversal, void*, const void*>;
+  using traversed_handle = std::conditional_t<mutable_traversal,
+                                              any_traversable&,
+                                              const any_traversable&>;
+
+  union storage {
+    alignas(std::max_align_t) unsigned char buffer[Size];
+    void* heap;
+  };
+
+  struct vtable {
+    void (*traverse)(object_pointer, visitor_ref<T>);
+    void* (*object)(storage&) noexcept;
+    void (*copy)(const storage&, storage&);
+    void (*move)(storage&, storage&) noexcept;
+    void (*destroy)(storage&) noexcept;
+  };
+
+  template <class U>
+  constexpr static inline bool stored_inline_v =
+      sizeof(U) <= Size && alignof(U) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<U>;
+
+  template <class U>
+  struct model {
+    using object_t = std::conditional_t<mutable_traversal, U, const U>;
+
+    static void traverse(object_pointer object, visitor_ref<T> visitor) {
+      dpsg::traverse(*static_cast<object_t*>(object), visitor);
+    }
+
+    static U* get(storage& s) noexcept {
+      if constexpr (stored_inline_v<U>) {
+        return std::launder(reinterpret_cast<U*>(s.buffer));
+      }
+      else {
+        return static_cast<U*>(s.heap);
+      }
+    }
+
+    static void* object(storage& s) noexcept { return get(s); }
+
+    template <class... Args>
+    static void construct(storage& s, Args&&... args) {
+      if constexpr (stored_inline_v<U>) {
+        ::new (static_cast<void*>(s.buffer)) U(std::forward<Args>(args)...);
+      }
+      else {
+        s.heap = new U(std::forward<Args>(args)...);
+      }
+    }
+
+    static void copy(const storage& from, storage& to) {
+      construct(to, *get(const_cast<storage&>(from)));
+    }
+
+    static void move(storage& from, storage& to) noexcept {
+      if constexpr (stored_inline_v<U>) {
+        construct(to, std::move(*get(from)));
+        get(from)->~U();
+      }
+      else {
+        to.heap = from.heap;
+      }
+    }
+
+    static void destroy(storage& s) noexcept {
+      if constexpr (stored_inline_v<U>) {
+        get(s)->~U();
+      }
+      else {
+        delete get(s);
+      }
+    }
+
+    constexpr static inline vtable table{
+        &traverse, &object, &copy, &move, &destroy};
+  };
+
+  // Keeps the converting constructor out of overload resolution (and
+  // std::is_constructible) for objects that can't be stored, or whose
+  // elements aren't T
+  template <class U>
+  constexpr static inline bool can_hold_v =
+      !std::is_same_v<U, any_traversable> && std::is_copy_constructible_v<U> &&
+      dpsg::is_traversable_v<typename model<U>::object_t&> &&
+      detail::elements_convert<T, typename model<U>::object_t>();
+
+ public:
+  any_traversable() noexcept = default;
+
+#if defined(__cpp_concepts)
+  template <class U>
+  requires(can_hold_v<std::decay_t<U>>)
+#else
+  template <class U, std::enable_if_t<can_hold_v<std::decay_t<U>>, int> = 0>
+#endif
+  any_traversable(U&& value)  // NOLINT: implicit on purpose
+      : any_traversable(std::in_place_type<std::decay_t<U>>,
+                        std::forward<U>(value)) {}
+
+  template <class U, class... Args>
+  explicit any_traversable([[maybe_unused]] std::in_place_type_t<U> tag,
+                           Args&&... args) {
+    static_assert(std::is_copy_constructible_v<U>,
+                  "dpsg::any_traversable requires copyable objects");
+    static_assert(dpsg::is_traversable_v<typename model<U>::object_t&>,
+                  "dpsg::any_traversable requires traversable objects");
+    static_assert(detail::elements_convert<T, typename model<U>::object_t>(),
+                  "dpsg::any_traversable requires elements convertible to T");
+    model<U>::construct(storage_, std::forward<Args>(args)...);
+    vtable_ = &model<U>::table;
+  }
+
+  any_traversable(const any_traversable& other) : vtable_{other.vtable_} {
+    if (vtable_ != nullptr) {
+      vtable_->copy(other.storage_, storage_);
+    }
+  }
+
+  any_traversable(any_traversable&& other) noexcept : vtable_{other.vtable_} {
+    if (vtable_ != nullptr) {
+      vtable_->move(other.storage_, storage_);
+      other.vtable_ = nullptr;
+    }
+  }
+
+  any_traversable& operator=(const any_traversable& other) {
+    if (this != &other) {
+      any_traversable copy{other};
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  any_traversable& operator=(any_traversable&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.vtable_ != nullptr) {
+        other.vtable_->move(other.storage_, storage_);
+        vtable_ = std::exchange(other.vtable_, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  ~any_traversable() { reset(); }
+
+  void reset() noexcept {
+    if (vtable_ != nullptr) {
+      vtable_->destroy(storage_);
+      vtable_ = nullptr;
+    }
+  }
+
+  [[nodiscard]] bool has_value() const noexcept { return vtable_ != nullptr; }
+
+  // Whether an object of type U would be stored without allocating
+  template <class U>
+  constexpr static inline bool stores_inline = stored_inline_v<U>;
+
+  // Traversing an empty handle visits nothing
+  template <class F, class... Args>
+  friend void dpsg_traverse(traversed_handle handle, F&& f, Args&&... args) {
+    if (handle.vtable_ == nullptr) {
+      return;
+    }
+    auto forward_element = [&f, &args...](T element) {
+      f(std::forward<T>(element), args...);
+    };
+    handle.vtable_->traverse(
+        handle.vtable_->object(const_cast<storage&>(handle.storage_)),
+        visitor_ref<T>{forward_element});
+  }
+
+ private:
+  const vtable* vtable_{nullptr};
+  storage storage_;
+};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_ANY_TRAVERSABLE_HPP
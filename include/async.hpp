@@ -0,0 +1,778 @@
+#ifndef GUARD_DPSG_ASYNC_HPP
+#define GUARD_DPSG_ASYNC_HPP
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "./traverse.hpp"
+
+/* async_traverse(executor, traversable, visitor, max_concurrency);
+   async_traverse(order, executor, traversable, visitor, complete,
+                  max_concurrency);
+
+    Traversal for visitors doing I/O on every element (querying a cache
+   daemon, writing a file...): the visitor may return an awaitable (an
+   awaiter, or a type with a member or free operator co_await), and up to
+   max_concurrency visits run at the same time on the given executor. The
+   traversal is itself a dpsg::task, to be co_awaited by another coroutine or
+   waited for with dpsg::sync_wait.
+
+        dpsg::thread_pool pool{4};
+        auto fetch_all = dpsg::async_traverse(
+            pool, keys, [&cache](const key& k) { return cache.fetch(k); }, 8);
+        dpsg::sync_wait(std::move(fetch_all));
+
+    When a completion function is given, it receives the result of every
+   visit (the value of the co_await expression, or of the call if the visitor
+   returns something that isn't awaitable; nothing if that's void), in one of
+   two orders:
+        - dpsg::unordered: as soon as each visit is over,
+        - dpsg::ordered: in the order in which the elements are traversed.
+          Visits that finish early wait for their predecessors, and keep
+          their place among the max_concurrency running visits in the
+          meantime, so that results never pile up.
+
+        co_await dpsg::async_traverse(dpsg::ordered, pool, chunks,
+                                      compress, write_to_file, 8);
+
+    Visits run concurrently and must be thread safe, completions are never
+   called concurrently. A max_concurrency of 0 lifts the limit. The first
+   exception thrown by a visit or a completion stops the launch of new
+   visits, and is rethrown by the traversal once the running ones are over.
+
+    Elements are reached with dpsg::traverse, which must give them as
+   lvalues: a pointer to each of them is stored before the visits start.
+   Lvalue traversables are referenced by the task and must outlive it,
+   rvalues are moved into it.
+
+    Executors are objects with an execute(f) member function running f()
+   somewhere, at some point. dpsg::inline_executor runs it immediately,
+   dpsg::thread_pool on a fixed set of threads. co_await
+   dpsg::schedule(executor) moves the current coroutine to an executor.
+*/
+
+namespace dpsg {
+
+template <class T = void>
+class task;
+
+namespace detail {
+
+template <class T>
+struct task_promise_base {
+  struct final_awaiter {
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+    template <class P>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<P> handle) const noexcept {
+      return handle.promise().continuation;
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  final_awaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+  task<T> get_return_object() noexcept;
+
+  std::coroutine_handle<> continuation{std::noop_coroutine()};
+  std::exception_ptr exception;
+};
+
+template <class T>
+struct task_promise : task_promise_base<T> {
+  template <class U>
+  void return_value(U&& value) {
+    result.emplace(std::forward<U>(value));
+  }
+
+  T get() {
+    if (this->exception) {
+      std::rethrow_exception(this->exception);
+    }
+    return std::move(*result);
+  }
+
+  std::optional<T> result;
+};
+
+template <>
+struct task_promise<void> : task_promise_base<void> {
+  void return_void() const noexcept {}
+
+  void get() const {
+    if (this->exception) {
+      std::rethrow_exception(this->exception);
+    }
+  }
+};
+
+}  // namespace detail
+
+// Lazily started coroutine, resuming the coroutine awaiting it when over
+template <class T>
+class task {
+ public:
+  using promise_type = detail::task_promise<T>;
+
+  task(task&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+  task& operator=(task&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~task() { destroy(); }
+
+  auto operator co_await() && noexcept {
+    struct awaiter {
+      std::coroutine_handle<promise_type> handle;
+      [[nodiscard]] bool await_ready() const noexcept {
+        return handle.done();
+      }
+      std::coroutine_handle<> await_suspend(
+          std::coroutine_handle<> awaiting) const noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+      }
+      T await_resume() const { return handle.promise().get(); }
+    };
+    return awaiter{handle_};
+  }
+
+ private:
+  friend struct detail::task_promise_base<T>;
+  explicit task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle_{handle} {}
+
+  void destroy() noexcept {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <class T>
+task<T> detail::task_promise_base<T>::get_return_object() noexcept {
+  return task<T>{std::coroutine_handle<task_promise<T>>::from_promise(
+      static_cast<task_promise<T>&>(*this))};
+}
+
+namespace detail {
+
+struct sync_wait_state {
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  bool done{false};
+  std::exception_ptr exception;
+};
+
+// Signals the thread blocked in sync_wait when over
+class blocking_task {
+ public:
+  struct promise_type {
+    template <class... Args>
+    explicit promise_type(sync_wait_state& state,
+                          [[maybe_unused]] Args&... args) noexcept
+        : state{&state} {}
+
+    struct final_awaiter {
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+      void await_suspend(
+          std::coroutine_handle<promise_type> handle) const noexcept {
+        sync_wait_state& state = *handle.promise().state;
+        std::lock_guard lock{state.mutex};
+        state.done = true;
+        state.done_cv.notify_one();
+      }
+      void await_resume() const noexcept {}
+    };
+
+    blocking_task get_return_object() noexcept {
+      return blocking_task{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    void unhandled_exception() noexcept {
+      state->exception = std::current_exception();
+    }
+
+    sync_wait_state* state;
+  };
+
+  blocking_task(blocking_task&& other) noexcept
+      : handle_{std::exchange(other.handle_, {})} {}
+  blocking_task& operator=(blocking_task&&) = delete;
+  ~blocking_task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  void run_and_wait(sync_wait_state& state) {
+    handle_.resume();
+    std::unique_lock lock{state.mutex};
+    state.done_cv.wait(lock, [&state] { return state.done; });
+  }
+
+ private:
+  explicit blocking_task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle_{handle} {}
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <class T>
+blocking_task wait_for([[maybe_unused]] sync_wait_state& state,
+                       task<T>& awaited,
+                       std::optional<T>& result) {
+  result.emplace(co_await std::move(awaited));
+}
+
+inline blocking_task wait_for([[maybe_unused]] sync_wait_state& state,
+                              task<void>& awaited) {
+  co_await std::move(awaited);
+}
+
+struct sync_wait_t {
+  // Blocks the calling thread until the task is over, and returns its result
+  template <class T>
+  T operator()(task<T> awaited) const {
+    sync_wait_state state;
+    if constexpr (std::is_void_v<T>) {
+      wait_for(state, awaited).run_and_wait(state);
+      if (state.exception) {
+        std::rethrow_exception(state.exception);
+      }
+    }
+    else {
+      std::optional<T> result;
+      wait_for(state, awaited, result).run_and_wait(state);
+      if (state.exception) {
+        std::rethrow_exception(state.exception);
+      }
+      return std::move(*result);
+    }
+  }
+};
+
+template <class Executor>
+struct schedule_awaiter {
+  Executor* executor;
+  [[nodiscard]] bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) const {
+    executor->execute([handle] { handle.resume(); });
+  }
+  void await_resume() const noexcept {}
+};
+
+struct schedule_t {
+  template <class Executor>
+  constexpr schedule_awaiter<Executor> operator()(
+      Executor& executor) const noexcept {
+    return schedule_awaiter<Executor>{&executor};
+  }
+};
+
+}  // namespace detail
+
+constexpr static inline detail::sync_wait_t sync_wait{};
+constexpr static inline detail::schedule_t schedule{};
+
+// Runs the work given to it immediately, on the calling thread
+struct inline_executor {
+  template <class F>
+  void execute(F&& f) const {
+    std::forward<F>(f)();
+  }
+};
+
+// Runs the work given to it on a fixed number of threads. The destructor
+// waits for the work already given to be over
+class thread_pool {
+ public:
+  explicit thread_pool(
+      std::size_t thread_count = std::thread::hardware_concurrency()) {
+    if (thread_count == 0) {
+      thread_count = 1;
+    }
+    threads_.reserve(thread_count);
+    for (std::size_t i = 0; i < thread_count; ++i) {
+      threads_.emplace_back([this] { work(); });
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool() {
+    {
+      std::lock_guard lock{mutex_};
+      stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  template <class F>
+  void execute(F&& f) {
+    {
+      std::lock_guard lock{mutex_};
+      work_.emplace_back(std::forward<F>(f));
+    }
+    work_cv_.notify_one();
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return threads_.size(); }
+
+ private:
+  void work() {
+    for (;;) {
+      std::function<void()> next;
+      {
+        std::unique_lock lock{mutex_};
+        work_cv_.wait(lock, [this] { return stopping_ || !work_.empty(); });
+        if (work_.empty()) {
+          return;
+        }
+        next = std::move(work_.front());
+        work_.pop_front();
+      }
+      next();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::deque<std::function<void()>> work_;
+  bool stopping_{false};
+  std::vector<std::thread> threads_;
+};
+
+struct ordered_t {};
+struct unordered_t {};
+
+constexpr static inline ordered_t ordered{};
+constexpr static inline unordered_t unordered{};
+
+namespace detail {
+
+template <class T, class = void>
+struct has_member_co_await : std::false_type {};
+template <class T>
+struct has_member_co_await<
+    T,
+    std::void_t<decltype(std::declval<T>().operator co_await())>>
+    : std::true_type {};
+
+// Found by ADL, in the namespace of the awaitable
+template <class T, class = void>
+struct has_free_co_await : std::false_type {};
+template <class T>
+struct has_free_co_await<
+    T,
+    std::void_t<decltype(operator co_await(std::declval<T>()))>>
+    : std::true_type {};
+
+template <class T, class = void>
+struct is_awaiter : std::false_type {};
+template <class T>
+struct is_awaiter<T, std::void_t<decltype(std::declval<T&>().await_ready())>>
+    : std::true_type {};
+
+template <class T>
+constexpr static inline bool is_awaitable_v =
+    has_member_co_await<T>::value || has_free_co_await<T>::value ||
+    is_awaiter<T>::value;
+
+template <class T>
+decltype(auto) get_awaiter(T&& awaitable) {
+  if constexpr (has_member_co_await<T>::value) {
+    return std::forward<T>(awaitable).operator co_await();
+  }
+  else if constexpr (has_free_co_await<T>::value) {
+    return operator co_await(std::forward<T>(awaitable));
+  }
+  else {
+    return std::forward<T>(awaitable);
+  }
+}
+
+template <class T>
+using await_result_t =
+    decltype(get_awaiter(std::declval<T>()).await_resume());
+
+// Result of a call, usable with co_await whether or not it is awaitable
+template <class T>
+struct ready_value {
+  T value;
+  [[nodiscard]] bool await_ready() const noexcept { return true; }
+  void await_suspend(std::coroutine_handle<>) const noexcept {}
+  T await_resume() { return std::move(value); }
+};
+
+template <class F, class E>
+decltype(auto) awaitable_call(F& visit, E& element) {
+  using result_t = std::invoke_result_t<F&, E&>;
+  if constexpr (is_awaitable_v<result_t>) {
+    return visit(element);
+  }
+  else if constexpr (std::is_void_v<result_t>) {
+    visit(element);
+    return std::suspend_never{};
+  }
+  else {
+    return ready_value<result_t>{visit(element)};
+  }
+}
+
+// Coroutine started on call and destroyed once over
+struct detached_task {
+  struct promise_type {
+    detached_task get_return_object() const noexcept { return {}; }
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+    void return_void() const noexcept {}
+    [[noreturn]] void unhandled_exception() const noexcept {
+      std::terminate();
+    }
+  };
+};
+
+struct ignore_completion {
+  template <class... Args>
+  constexpr void operator()([[maybe_unused]] Args&&... args) const noexcept {}
+};
+
+// Shared by the coroutine launching the visits and the visits themselves.
+// Lives in the frame of the former, which waits for all the visits to be
+// over before returning
+template <class Order, class Executor, class F, class C>
+class async_traversal {
+ public:
+  using index = std::size_t;
+
+  async_traversal(Executor& executor,
+                  F& visit,
+                  C& complete,
+                  std::size_t max_concurrency,
+                  std::size_t size)
+      : executor_{&executor},
+        visit_{&visit},
+        complete_{&complete},
+        max_concurrency_{max_concurrency} {
+    if constexpr (std::is_same_v<Order, ordered_t>) {
+      const std::size_t window =
+          max_concurrency == 0 || max_concurrency > size ? size
+                                                         : max_concurrency;
+      waiting_turn_.resize(window);
+    }
+  }
+
+  Executor& executor() const noexcept { return *executor_; }
+
+  template <class E>
+  decltype(auto) visit(E& element) const {
+    return awaitable_call(*visit_, element);
+  }
+
+  template <class... R>
+  void complete(R&&... result) {
+    if constexpr (std::is_same_v<Order, ordered_t>) {
+      // Only the visit whose turn it is gets here
+      (*complete_)(std::forward<R>(result)...);
+    }
+    else {
+      std::lock_guard lock{complete_mutex_};
+      (*complete_)(std::forward<R>(result)...);
+    }
+  }
+
+  // Suspends the launching coroutine until a visit may start
+  auto slot() noexcept {
+    struct awaiter {
+      async_traversal* self;
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+      bool await_suspend(std::coroutine_handle<> handle) const {
+        std::lock_guard lock{self->mutex_};
+        if (self->error_ || self->max_concurrency_ == 0 ||
+            self->in_flight_ < self->max_concurrency_) {
+          return false;
+        }
+        self->launcher_ = handle;
+        self->launcher_waits_for_all_ = false;
+        return true;
+      }
+      void await_resume() const noexcept {}
+    };
+    return awaiter{this};
+  }
+
+  // Counts a visit as running, unless a visit already failed
+  bool take_slot() {
+    std::lock_guard lock{mutex_};
+    if (error_) {
+      return false;
+    }
+    ++in_flight_;
+    return true;
+  }
+
+  // Suspends the launching coroutine until all the visits are over
+  auto drained() noexcept {
+    struct awaiter {
+      async_traversal* self;
+      [[nodiscard]] bool await_ready() const noexcept { return false; }
+      bool await_suspend(std::coroutine_handle<> handle) const {
+        std::lock_guard lock{self->mutex_};
+        if (self->in_flight_ == 0) {
+          return false;
+        }
+        self->launcher_ = handle;
+        self->launcher_waits_for_all_ = true;
+        return true;
+      }
+      void await_resume() const noexcept {}
+    };
+    return awaiter{this};
+  }
+
+  // Suspends visit i until its result may be given to the completion
+  // function. Returns false if the traversal failed in the meantime
+  auto turn(index i) noexcept {
+    struct awaiter {
+      async_traversal* self;
+      index i;
+      [[nodiscard]] bool await_ready() const noexcept {
+        return std::is_same_v<Order, unordered_t>;
+      }
+      bool await_suspend(std::coroutine_handle<> handle) const {
+        std::lock_guard lock{self->mutex_};
+        if (self->error_ || self->next_ == i) {
+          return false;
+        }
+        self->waiting_turn_[i % self->waiting_turn_.size()] = handle;
+        return true;
+      }
+      bool await_resume() const {
+        std::lock_guard lock{self->mutex_};
+        return !self->error_;
+      }
+    };
+    return awaiter{this, i};
+  }
+
+  void fail(std::exception_ptr error) {
+    std::vector<std::coroutine_handle<>> waiting;
+    {
+      std::lock_guard lock{mutex_};
+      if (!error_) {
+        error_ = std::move(error);
+      }
+      for (auto& handle : waiting_turn_) {
+        if (handle) {
+          waiting.push_back(std::exchange(handle, {}));
+        }
+      }
+    }
+    for (auto handle : waiting) {
+      resume_on(*executor_, handle);
+    }
+  }
+
+  // Called last by visit i. The traversal may be destroyed as soon as the
+  // lock is released
+  void release(index i) {
+    Executor& executor = *executor_;
+    std::coroutine_handle<> next_in_line;
+    std::coroutine_handle<> launcher;
+    {
+      std::lock_guard lock{mutex_};
+      if constexpr (std::is_same_v<Order, ordered_t>) {
+        if (!error_ && next_ == i) {
+          ++next_;
+          next_in_line = std::exchange(
+              waiting_turn_[next_ % waiting_turn_.size()], {});
+        }
+      }
+      --in_flight_;
+      if (launcher_ && (in_flight_ == 0 || !launcher_waits_for_all_)) {
+        launcher = std::exchange(launcher_, {});
+      }
+    }
+    if (next_in_line) {
+      resume_on(executor, next_in_line);
+    }
+    if (launcher) {
+      resume_on(executor, launcher);
+    }
+  }
+
+  [[nodiscard]] std::exception_ptr error() {
+    std::lock_guard lock{mutex_};
+    return error_;
+  }
+
+ private:
+  static void resume_on(Executor& executor, std::coroutine_handle<> handle) {
+    executor.execute([handle] { handle.resume(); });
+  }
+
+  std::mutex mutex_;
+  std::mutex complete_mutex_;
+  Executor* executor_;
+  F* visit_;
+  C* complete_;
+  std::size_t max_concurrency_;
+  std::size_t in_flight_{0};
+  // Ordered completions: next visit to complete, and visits waiting for
+  // their turn, by index modulo the number of visits running at once
+  index next_{0};
+  std::vector<std::coroutine_handle<>> waiting_turn_;
+  std::coroutine_handle<> launcher_;
+  bool launcher_waits_for_all_{false};
+  std::exception_ptr error_;
+};
+
+template <class State, class E>
+detached_task visit_one(State& state, E& element, std::size_t i) {
+  try {
+    // An executor may fail to schedule the visit, that is an error of the
+    // traversal like any other
+    co_await dpsg::schedule(state.executor());
+    using result_t = await_result_t<decltype(state.visit(element))>;
+    if constexpr (std::is_void_v<result_t>) {
+      co_await state.visit(element);
+      if (co_await state.turn(i)) {
+        state.complete();
+      }
+    }
+    else {
+      auto result = co_await state.visit(element);
+      if (co_await state.turn(i)) {
+        state.complete(std::move(result));
+      }
+    }
+  }
+  catch (...) {
+    state.fail(std::current_exception());
+  }
+  state.release(i);
+}
+
+template <class State>
+struct async_element {
+  void* element;
+  void (*launch)(State&, void*, std::size_t);
+};
+
+template <class State, class E>
+void launch_visit(State& state, void* element, std::size_t i) {
+  visit_one(state, *static_cast<E*>(element), i);
+}
+
+template <class Order, class Executor, class T, class F, class C>
+task<void> async_traverse(Executor& executor,
+                          T source,
+                          F visit,
+                          C complete,
+                          std::size_t max_concurrency) {
+  using state_t = async_traversal<Order, Executor, F, C>;
+  std::vector<async_element<state_t>> elements;
+  dpsg::traverse(source, [&elements](auto&& element) {
+    static_assert(std::is_lvalue_reference_v<decltype(element)>,
+                  "async_traverse needs the elements to be lvalues");
+    using element_t = std::remove_reference_t<decltype(element)>;
+    elements.push_back(
+        {const_cast<void*>(static_cast<const void*>(std::addressof(element))),
+         &launch_visit<state_t, element_t>});
+  });
+
+  state_t state{executor, visit, complete, max_concurrency, elements.size()};
+  for (std::size_t i = 0; i < elements.size(); ++i) {
+    co_await state.slot();
+    if (!state.take_slot()) {
+      break;
+    }
+    elements[i].launch(state, elements[i].element, i);
+  }
+  co_await state.drained();
+  if (auto error = state.error()) {
+    std::rethrow_exception(error);
+  }
+}
+
+template <class T, class = void>
+struct is_executor : std::false_type {};
+template <class T>
+struct is_executor<T,
+                   std::void_t<decltype(std::declval<T&>().execute(
+                       std::declval<void (*)()>()))>> : std::true_type {};
+
+struct async_traverse_t {
+  template <class Executor,
+            class T,
+            class F,
+            std::enable_if_t<is_executor<Executor>::value, int> = 0>
+  task<void> operator()(Executor& executor,
+                        T&& traversable,
+                        F&& visit,
+                        std::size_t max_concurrency) const {
+    return detail::async_traverse<unordered_t, Executor, T>(
+        executor,
+        std::forward<T>(traversable),
+        std::forward<F>(visit),
+        ignore_completion{},
+        max_concurrency);
+  }
+
+  template <class Order,
+            class Executor,
+            class T,
+            class F,
+            class C,
+            std::enable_if_t<std::is_same_v<Order, ordered_t> ||
+                                 std::is_same_v<Order, unordered_t>,
+                             int> = 0>
+  task<void> operator()([[maybe_unused]] Order order,
+                        Executor& executor,
+                        T&& traversable,
+                        F&& visit,
+                        C&& complete,
+                        std::size_t max_concurrency) const {
+    static_assert(is_executor<Executor>::value,
+                  "executors need an execute(f) member function");
+    return detail::async_traverse<Order, Executor, T>(
+        executor,
+        std::forward<T>(traversable),
+        std::forward<F>(visit),
+        std::forward<C>(complete),
+        max_concurrency);
+  }
+};
+
+}  // namespace detail
+
+constexpr static inline detail::async_traverse_t async_traverse{};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_ASYNC_HPP
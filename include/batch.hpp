@@ -0,0 +1,348 @@
+#ifndef GUARD_DPSG_BATCH_HPP
+#define GUARD_DPSG_BATCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#include "./composite.hpp"
+#include "./is_range.hpp"
+#include "./is_template_instance.hpp"
+
+/* template<std::size_t ChunkSize, class T, class F, class... Args>
+   void traverse_batched(T&& t, F&& f, Args&&... args);
+
+    Batched visitation: instead of being called once per element, the visitor
+   is handed groups of elements of the same type, so that it can amortize its
+   setup costs (issuing draw calls or database writes in bulk...).
+
+        - For tuples, pairs and composites (whose direct components are
+          considered), elements are grouped by type at compile time. The
+          visitor is called once per distinct type, in order of first
+          appearance, with a dpsg::batch of references to the elements of that
+          type, in their original order.
+        - For contiguous ranges (std::vector, std::array, C arrays...), the
+          visitor is called with std::span chunks of at most ChunkSize
+          elements.
+        - For other ranges, the visitor is called with dpsg::batch chunks of
+          at most ChunkSize references. Ranges whose elements are produced
+          on the fly (a transformed view...) have their values copied to a
+          buffer of ChunkSize elements first, which the batch refers to.
+   Strings and string views are not ranges here, as with dpsg::traverse.
+
+        std::tuple<circle, square, circle> shapes;
+        dpsg::traverse_batched(shapes, overload_set{
+            [](dpsg::batch<circle, 2> circles) { draw_circles(circles); },
+            [](dpsg::batch<square, 1> squares) { draw_squares(squares); }});
+
+        std::vector<row> rows;
+        dpsg::traverse_batched<256>(rows, [&db](std::span<row> chunk) {
+          db.insert(chunk.data(), chunk.size());
+        });
+
+    A batch<T, N> is a range of at most N references to T, with a size(), an
+   operator[] and begin()/end().
+*/
+
+namespace dpsg {
+
+constexpr static inline std::size_t default_batch_size = 64;
+
+template <class T, std::size_t N>
+class batch {
+ public:
+  using value_type = std::remove_cv_t<T>;
+  using reference = T&;
+
+  class iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    constexpr iterator() noexcept = default;
+    constexpr explicit iterator(T* const* current) noexcept
+        : current_{current} {}
+
+    constexpr T& operator*() const noexcept { return **current_; }
+    constexpr T* operator->() const noexcept { return *current_; }
+    constexpr T& operator[](difference_type n) const noexcept {
+      return *current_[n];
+    }
+    constexpr iterator& operator++() noexcept {
+      ++current_;
+      return *this;
+    }
+    constexpr iterator operator++(int) noexcept { return iterator{current_++}; }
+    constexpr iterator& operator--() noexcept {
+      --current_;
+      return *this;
+    }
+    constexpr iterator operator--(int) noexcept { return iterator{current_--}; }
+    constexpr iterator& operator+=(difference_type n) noexcept {
+      current_ += n;
+      return *this;
+    }
+    constexpr iterator& operator-=(difference_type n) noexcept {
+      current_ -= n;
+      return *this;
+    }
+    constexpr friend iterator operator+(iterator it,
+                                        difference_type n) noexcept {
+      return it += n;
+    }
+    constexpr friend iterator operator+(difference_type n,
+                                        iterator it) noexcept {
+      return it += n;
+    }
+    constexpr friend iterator operator-(iterator it,
+                                        difference_type n) noexcept {
+      return it -= n;
+    }
+    constexpr friend difference_type operator-(iterator l,
+                                               iterator r) noexcept {
+      return l.current_ - r.current_;
+    }
+    constexpr friend bool operator==(iterator l, iterator r) noexcept {
+      return l.current_ == r.current_;
+    }
+    constexpr friend bool operator!=(iterator l, iterator r) noexcept {
+      return l.current_ != r.current_;
+    }
+    constexpr friend bool operator<(iterator l, iterator r) noexcept {
+      return l.current_ < r.current_;
+    }
+    constexpr friend bool operator>(iterator l, iterator r) noexcept {
+      return l.current_ > r.current_;
+    }
+    constexpr friend bool operator<=(iterator l, iterator r) noexcept {
+      return l.current_ <= r.current_;
+    }
+    constexpr friend bool operator>=(iterator l, iterator r) noexcept {
+      return l.current_ >= r.current_;
+    }
+
+   private:
+    T* const* current_{nullptr};
+  };
+
+  constexpr batch() noexcept = default;
+  constexpr explicit batch(std::array<T*, N> elements,
+                           std::size_t size = N) noexcept
+      : elements_{elements}, size_{size} {}
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+  [[nodiscard]] constexpr static std::size_t capacity() noexcept { return N; }
+
+  constexpr T& operator[](std::size_t i) const noexcept {
+    return *elements_[i];
+  }
+
+  constexpr iterator begin() const noexcept {
+    return iterator{elements_.data()};
+  }
+  constexpr iterator end() const noexcept {
+    return iterator{elements_.data() + size_};
+  }
+
+  // Used to fill chunks of non-contiguous ranges
+  constexpr void push_back(T& element) noexcept {
+    elements_[size_++] = std::addressof(element);
+  }
+  constexpr void clear() noexcept { size_ = 0; }
+
+ private:
+  std::array<T*, N> elements_{};
+  std::size_t size_{0};
+};
+
+namespace detail {
+
+template <class U, class... Ts>
+constexpr std::size_t first_index_of() noexcept {
+  constexpr bool matches[] = {std::is_same_v<U, Ts>...};
+  std::size_t i = 0;
+  while (!matches[i]) {
+    ++i;
+  }
+  return i;
+}
+
+// For every element, the index of the first element of the same type
+template <class... Ts>
+constexpr static inline std::array<std::size_t, sizeof...(Ts)> group_leaders{
+    first_index_of<Ts, Ts...>()...};
+
+template <std::size_t Leader, class... Ts>
+constexpr std::size_t group_size() noexcept {
+  std::size_t count = 0;
+  for (auto leader : group_leaders<Ts...>) {
+    count += static_cast<std::size_t>(leader == Leader);
+  }
+  return count;
+}
+
+template <std::size_t Leader, class... Ts>
+constexpr std::array<std::size_t, group_size<Leader, Ts...>()>
+group_indices() noexcept {
+  std::array<std::size_t, group_size<Leader, Ts...>()> indices{};
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+    if (group_leaders<Ts...>[i] == Leader) {
+      indices[next++] = i;
+    }
+  }
+  return indices;
+}
+
+// std::get for tuples and pairs, dpsg::get for compressed tuples
+template <class T, std::size_t I>
+using element_t = std::remove_reference_t<decltype(get<I>(
+    std::declval<std::remove_reference_t<T>&>()))>;
+
+template <std::size_t Leader,
+          class... Ts,
+          class T,
+          class F,
+          class... Args,
+          std::size_t... Ks>
+constexpr void visit_group(T& tuple,
+                           F& f,
+                           [[maybe_unused]] std::index_sequence<Ks...> marker,
+                           Args&... args) {
+  constexpr auto indices = group_indices<Leader, Ts...>();
+  using batch_t = batch<element_t<T, Leader>, sizeof...(Ks)>;
+  f(batch_t{{std::addressof(get<indices[Ks]>(tuple))...}}, args...);
+}
+
+template <class... Ts, class T, class F, class... Args, std::size_t... Is>
+constexpr void visit_groups([[maybe_unused]] T& tuple,
+                            [[maybe_unused]] F& f,
+                            [[maybe_unused]] std::index_sequence<Is...> marker,
+                            [[maybe_unused]] Args&... args) {
+  (
+      [&] {
+        if constexpr (group_leaders<Ts...>[Is] == Is) {
+          visit_group<Is, Ts...>(
+              tuple,
+              f,
+              std::make_index_sequence<group_size<Is, Ts...>()>{},
+              args...);
+        }
+      }(),
+      ...);
+}
+
+template <class... Ts>
+struct group_by_type {
+  template <class T, class F, class... Args>
+  constexpr static void apply(T& tuple, F& f, Args&... args) {
+    visit_groups<std::decay_t<Ts>...>(
+        tuple, f, std::index_sequence_for<Ts...>{}, args...);
+  }
+};
+
+}  // namespace detail
+
+template <std::size_t ChunkSize = default_batch_size,
+          class T,
+          class F,
+          class... Args>
+constexpr void traverse_batched(T&& t, F&& f, Args&&... args) {
+  static_assert(ChunkSize > 0, "batches must hold at least one element");
+  using value_t = std::remove_reference_t<T>;
+
+  if constexpr (is_composite_v<value_t>) {
+    traverse_batched<ChunkSize>(t.components, f, args...);
+  }
+  else if constexpr (is_template_instance_v<std::remove_cv_t<value_t>,
+                                            std::tuple> ||
+                     is_template_instance_v<std::remove_cv_t<value_t>,
+                                            std::pair> ||
+                     is_template_instance_v<std::remove_cv_t<value_t>,
+                                            compressed_tuple>) {
+    feed_t<value_t, detail::group_by_type>::apply(t, f, args...);
+  }
+  else if constexpr (detail::is_contiguous_range<value_t>::value &&
+                     !detail::is_text_v<value_t>) {
+    auto* data = std::data(t);
+    const std::size_t size = std::size(t);
+    using element_t = std::remove_pointer_t<decltype(data)>;
+    for (std::size_t offset = 0; offset < size; offset += ChunkSize) {
+      const std::size_t count =
+          size - offset < ChunkSize ? size - offset : ChunkSize;
+#if defined(__cpp_lib_span)
+      f(std::span<element_t>{data + offset, count}, args...);
+#else
+      batch<element_t, ChunkSize> chunk;
+      for (std::size_t i = 0; i < count; ++i) {
+        chunk.push_back(data[offset + i]);
+      }
+      f(chunk, args...);
+#endif
+    }
+  }
+  else if constexpr (is_range_v<value_t> && !detail::is_text_v<value_t>) {
+    using reference_t =
+        decltype(*detail::adl_begin(std::declval<value_t&>()));
+    if constexpr (std::is_lvalue_reference_v<reference_t>) {
+      batch<std::remove_reference_t<reference_t>, ChunkSize> chunk;
+      for (auto& element : t) {
+        chunk.push_back(element);
+        if (chunk.size() == ChunkSize) {
+          f(chunk, args...);
+          chunk.clear();
+        }
+      }
+      if (!chunk.empty()) {
+        f(chunk, args...);
+      }
+    }
+    else {
+      // Elements produced on the fly (transformed views, generators...)
+      // don't outlive the iteration, the values are kept for the chunk
+      using element_t = std::remove_cv_t<std::remove_reference_t<reference_t>>;
+      std::vector<element_t> values;
+      values.reserve(ChunkSize);
+      batch<element_t, ChunkSize> chunk;
+      const auto flush = [&] {
+        for (auto& value : values) {
+          chunk.push_back(value);
+        }
+        f(chunk, args...);
+        chunk.clear();
+        values.clear();
+      };
+      for (auto&& element : t) {
+        values.push_back(std::forward<decltype(element)>(element));
+        if (values.size() == ChunkSize) {
+          flush();
+        }
+      }
+      if (!values.empty()) {
+        flush();
+      }
+    }
+  }
+  else {
+    static_assert(is_range_v<value_t> && !detail::is_text_v<value_t>,
+                  "dpsg::traverse_batched supports tuples, pairs, composites "
+                  "and ranges other than strings");
+  }
+}
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_BATCH_HPP
@@ -0,0 +1,333 @@
+#ifndef GUARD_DPSG_BY_ALTERNATIVE_HPP
+#define GUARD_DPSG_BY_ALTERNATIVE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./is_range.hpp"
+#include "./is_template_instance.hpp"
+
+/* traverse_by_alternative(range, f, args...);
+   fold_by_alternative(range, acc, f, args...);
+   sort_by_alternative(range);
+   template<class Variant> class alternative_index;
+
+    Traversals of ranges of variants dispatching on the alternative once per
+   group of elements rather than once per element. dpsg::traverse and
+   dpsg::fold call std::visit on every element, and when alternatives are
+   mixed at random the indirect branch it goes through is mispredicted most of
+   the time.
+
+        - traverse_by_alternative and fold_by_alternative visit the elements
+          in order, but dispatch once per run of consecutive elements holding
+          the same alternative, followed by a tight loop over the run. They
+          are as fast as the runs are long.
+        - sort_by_alternative reorders a range (stably) so that each
+          alternative forms a single run. For visitors that don't care about
+          order, and data that may be reordered.
+        - alternative_index<Variant> stores the positions of the elements of
+          a random access range, grouped by alternative. Its traverse and fold
+          member functions then run one tight loop per alternative, without
+          touching the order of the range. Changing the value of an element
+          keeps the index valid as long as the alternative stays the same.
+
+        std::vector<std::variant<circle, square>> shapes = ...;
+        dpsg::sort_by_alternative(shapes);
+        double area = dpsg::fold_by_alternative(
+            shapes, 0.0, [](double acc, const auto& s) {
+              return acc + s.area();
+            });
+
+        dpsg::alternative_index<std::variant<circle, square>> index{shapes};
+        index.traverse(shapes, [](auto& s) { s.scale(2); });
+
+    The visitor receives the alternatives themselves (with the extra
+   arguments), as with std::visit. Elements valueless by exception make these
+   functions throw std::bad_variant_access.
+
+    benchmarks/by_alternative.cpp, 2^22 shapes of 3 kinds in random order,
+   summing their areas: a fold with a prebuilt index takes 0.52x the time of
+   dpsg::fold, and a fold over the sorted range 0.21x (once sorted, the
+   branch of std::visit is well predicted too). Building the index costs
+   about a third of a dpsg::fold, sorting a little over two. Run dispatch
+   over the random order is slower than std::visit (1.15x): runs are only
+   1.5 elements long on average.
+*/
+
+namespace dpsg {
+
+namespace detail {
+
+template <class R>
+using range_element_t =
+    std::remove_reference_t<decltype(*adl_begin(std::declval<R&>()))>;
+
+template <class R>
+constexpr static inline bool is_variant_range_v =
+    is_template_instance_v<std::remove_cv_t<range_element_t<R>>,
+                           std::variant>;
+
+template <class V>
+constexpr std::size_t alternative_of(const V& variant) {
+  const std::size_t i = variant.index();
+  if (i == std::variant_npos) {
+    throw std::bad_variant_access{};
+  }
+  return i;
+}
+
+// Handlers for a run of elements holding alternative I, indexed by I
+template <class It, class S, class F, class... Args>
+struct run_visitor {
+  using handler_t = It (*)(It, S, F&, Args&...);
+
+  template <std::size_t I>
+  static It visit(It first, S last, F& f, Args&... args) {
+    do {
+      f(*std::get_if<I>(std::addressof(*first)), args...);
+      ++first;
+    } while (first != last && (*first).index() == I);
+    return first;
+  }
+
+  template <std::size_t... Is>
+  constexpr static inline handler_t table[] = {&visit<Is>...};
+};
+
+template <class A, class It, class S, class F, class... Args>
+struct run_folder {
+  using handler_t = It (*)(A&, It, S, F&, Args&...);
+
+  // The accumulator is kept in a local for the length of the run, where the
+  // compiler knows that the elements can't alias it
+  template <std::size_t I>
+  static It fold(A& acc, It first, S last, F& fun, Args&... args) {
+    A local = std::move(acc);
+    do {
+      local = fun(std::move(local), *std::get_if<I>(std::addressof(*first)),
+                  args...);
+      ++first;
+    } while (first != last && (*first).index() == I);
+    acc = std::move(local);
+    return first;
+  }
+
+  template <std::size_t... Is>
+  constexpr static inline handler_t table[] = {&fold<Is>...};
+};
+
+template <class Handlers, class V, std::size_t... Is>
+constexpr auto& run_handlers(
+    [[maybe_unused]] std::index_sequence<Is...> marker) noexcept {
+  return Handlers::template table<Is...>;
+}
+
+template <class V>
+using alternatives_t =
+    std::make_index_sequence<std::variant_size_v<std::remove_cv_t<V>>>;
+
+struct traverse_by_alternative_t {
+  template <class R,
+            class F,
+            class... Args,
+            std::enable_if_t<is_variant_range_v<R>, int> = 0>
+  void operator()(R&& range, F&& f, Args&&... args) const {
+    using element_t = range_element_t<R>;
+    auto first = adl_begin(range);
+    auto last = adl_end(range);
+    using handlers_t =
+        run_visitor<decltype(first), decltype(last), F, Args...>;
+    constexpr auto& handlers =
+        run_handlers<handlers_t, element_t>(alternatives_t<element_t>{});
+    while (first != last) {
+      first = handlers[alternative_of(*first)](first, last, f, args...);
+    }
+  }
+};
+
+struct fold_by_alternative_t {
+  template <class R,
+            class A,
+            class F,
+            class... Args,
+            std::enable_if_t<is_variant_range_v<R>, int> = 0>
+  std::decay_t<A> operator()(R&& range, A&& acc, F&& fun, Args&&... args)
+      const {
+    using element_t = range_element_t<R>;
+    std::decay_t<A> result = std::forward<A>(acc);
+    auto first = adl_begin(range);
+    auto last = adl_end(range);
+    using handlers_t = run_folder<std::decay_t<A>,
+                                  decltype(first),
+                                  decltype(last),
+                                  F,
+                                  Args...>;
+    constexpr auto& handlers =
+        run_handlers<handlers_t, element_t>(alternatives_t<element_t>{});
+    while (first != last) {
+      first =
+          handlers[alternative_of(*first)](result, first, last, fun, args...);
+    }
+    return result;
+  }
+};
+
+// A stable counting sort on the index: one pass counts the elements of every
+// alternative (and finds the valueless ones before anything is moved), a
+// second one scatters their positions to their final place, then the
+// elements are moved to a buffer in that order and back. Linear in the size
+// of the range, whatever the number of alternatives
+struct sort_by_alternative_t {
+  template <class R, std::enable_if_t<is_variant_range_v<R>, int> = 0>
+  void operator()(R&& range) const {
+    using element_t = range_element_t<R>;
+    constexpr std::size_t alternatives = std::variant_size_v<element_t>;
+    std::array<std::size_t, alternatives + 1> offsets{};
+    for (const auto& element : range) {
+      ++offsets[alternative_of(element) + 1];
+    }
+    for (std::size_t i = 1; i <= alternatives; ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+
+    using iterator_t = decltype(adl_begin(range));
+    std::vector<iterator_t> order(offsets[alternatives]);
+    for (auto it = adl_begin(range); it != adl_end(range); ++it) {
+      order[offsets[(*it).index()]++] = it;
+    }
+
+    std::vector<element_t> sorted;
+    sorted.reserve(order.size());
+    for (const auto& it : order) {
+      sorted.push_back(std::move(*it));
+    }
+    std::move(sorted.begin(), sorted.end(), adl_begin(range));
+  }
+};
+
+}  // namespace detail
+
+constexpr static inline detail::traverse_by_alternative_t
+    traverse_by_alternative{};
+constexpr static inline detail::fold_by_alternative_t fold_by_alternative{};
+constexpr static inline detail::sort_by_alternative_t sort_by_alternative{};
+
+template <class Variant>
+class alternative_index {
+  static_assert(is_template_instance_v<Variant, std::variant>,
+                "alternative_index is built over ranges of std::variant");
+
+ public:
+  constexpr static inline std::size_t alternative_count =
+      std::variant_size_v<Variant>;
+
+  alternative_index() = default;
+  template <class R>
+  explicit alternative_index(const R& range) {
+    assign(range);
+  }
+
+  template <class R>
+  void assign(const R& range) {
+    static_assert(
+        std::is_same_v<std::remove_cv_t<detail::range_element_t<const R>>,
+                       Variant>,
+        "the range doesn't hold the variant type of the index");
+    clear();
+    std::size_t i = 0;
+    for (const auto& element : range) {
+      positions_[detail::alternative_of(element)].push_back(i++);
+    }
+  }
+
+  void clear() noexcept {
+    for (auto& positions : positions_) {
+      positions.clear();
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    std::size_t total = 0;
+    for (const auto& positions : positions_) {
+      total += positions.size();
+    }
+    return total;
+  }
+
+  // Positions of the elements holding a given alternative, in order
+  [[nodiscard]] const std::vector<std::size_t>& positions(
+      std::size_t alternative) const noexcept {
+    return positions_[alternative];
+  }
+
+  // Visits the elements of the range, grouped by alternative
+  template <class R, class F, class... Args>
+  void traverse(R&& range, F&& f, Args&&... args) const {
+    traverse_alternatives(detail::adl_begin(range),
+                          f,
+                          std::make_index_sequence<alternative_count>{},
+                          args...);
+  }
+
+  template <class R, class A, class F, class... Args>
+  std::decay_t<A> fold(R&& range, A&& acc, F&& fun, Args&&... args) const {
+    std::decay_t<A> result = std::forward<A>(acc);
+    fold_alternatives(detail::adl_begin(range),
+                      result,
+                      fun,
+                      std::make_index_sequence<alternative_count>{},
+                      args...);
+    return result;
+  }
+
+ private:
+  template <class It, class F, class... Args, std::size_t... Is>
+  void traverse_alternatives(It first,
+                             F& f,
+                             [[maybe_unused]] std::index_sequence<Is...> marker,
+                             Args&... args) const {
+    (
+        [&] {
+          for (std::size_t i : positions_[Is]) {
+            f(*std::get_if<Is>(std::addressof(first[i])), args...);
+          }
+        }(),
+        ...);
+  }
+
+  template <class It, class A, class F, class... Args, std::size_t... Is>
+  void fold_alternatives(It first,
+                         A& acc,
+                         F& fun,
+                         [[maybe_unused]] std::index_sequence<Is...> marker,
+                         Args&... args) const {
+    (
+        [&] {
+          A local = std::move(acc);
+          for (std::size_t i : positions_[Is]) {
+            local = fun(std::move(local),
+                        *std::get_if<Is>(std::addressof(first[i])),
+                        args...);
+          }
+          acc = std::move(local);
+        }(),
+        ...);
+  }
+
+  std::array<std::vector<std::size_t>, alternative_count> positions_;
+};
+
+template <class R>
+alternative_index(const R&)
+    -> alternative_index<std::remove_cv_t<detail::range_element_t<const R>>>;
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_BY_ALTERNATIVE_HPP
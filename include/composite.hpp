@@ -1,6 +1,7 @@
 #ifndef GUARD_DPSG_COMPOSITE_HPP
 #define GUARD_DPSG_COMPOSITE_HPP
 
+#include "./compressed_tuple.hpp"
 #include "./traverse.hpp"
 
 namespace dpsg {
@@ -17,7 +18,11 @@ struct composite {
   constexpr explicit composite(Args2&&... args) noexcept
       : components{std::forward<Args2>(args)...} {}
 
-  std::tuple<Args...> components;
+  // Empty components take no room and the others are stored so as to
+  // minimize padding, see compressed_tuple.hpp. This is not a std::tuple:
+  // access components with dpsg::get<I> or structured bindings, std::get
+  // and std::apply don't work on it
+  DPSG_NO_UNIQUE_ADDRESS compressed_tuple<Args...> components;
 
   template <class C,
             class F,
@@ -48,15 +53,25 @@ struct composite {
         (void)(f);
       }
       else {
-        (dpsg::traverse(std::get<Is>(c1.components),
-                        f,
-                        std::forward<decltype(user_input)>(user_input)...),
-         ...);
+        // Every component gets the arguments, none can be moved from
+        (dpsg::traverse(get<Is>(c1.components), f, user_input...), ...);
       }
     };
   }
 };
 
+namespace detail {
+template <class... Args>
+constexpr std::true_type derives_from_composite(const composite<Args...>*);
+constexpr std::false_type derives_from_composite(...);
+}  // namespace detail
+
+// True for dpsg::composite and the classes deriving from it
+template <class T>
+constexpr static inline bool is_composite_v =
+    decltype(detail::derives_from_composite(
+        std::declval<std::remove_reference_t<T>*>()))::value;
+
 }  // namespace dpsg
 
 #endif  // GUARD_DPSG_COMPOSITE_HPP
@@ -0,0 +1,213 @@
+#ifndef GUARD_DPSG_COMPRESSED_TUPLE_HPP
+#define GUARD_DPSG_COMPRESSED_TUPLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./unroll.hpp"
+
+/* template<class... Ts> class compressed_tuple;
+
+    A tuple laid out to take as little room as possible, used as the storage
+   of dpsg::composite:
+        - empty elements take no room at all ([[no_unique_address]]),
+        - elements are stored by decreasing alignment rather than in the order
+          in which they are declared, which minimizes padding.
+
+        static_assert(sizeof(std::tuple<char, double, char>) == 24);
+        static_assert(
+            sizeof(dpsg::compressed_tuple<char, double, char>) == 16);
+
+    The storage order is an implementation detail: elements are accessed by
+   their declared index with dpsg::get<I>, structured bindings work as for
+   std::tuple, and traversals and folds visit the elements in declaration
+   order.
+
+        dpsg::compressed_tuple<char, double, char> t{'a', 1.5, 'b'};
+        dpsg::get<1>(t) = 2.5;
+        auto& [first, second, third] = t;
+        dpsg::traverse(t, print);  // a, 2.5, b
+
+    Empty elements still have distinct addresses when they are of the same
+   type, as required by the language.
+
+    std::tuple_size and std::tuple_element are specialized, and dpsg::get is
+   found through ADL, but a compressed_tuple is not a std::tuple: std::get
+   and std::apply don't accept it. Since the components of dpsg::composite
+   are stored in one, code calling std::get<I>(c.components) must use an
+   unqualified (or dpsg::) get<I>, or a structured binding, instead. Large
+   compressed tuples are traversed and folded with the same indexed dispatch
+   as std::tuple, see unroll.hpp.
+*/
+
+#if defined(_MSC_VER)
+#define DPSG_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#elif defined(__has_cpp_attribute)
+#if __has_cpp_attribute(no_unique_address)
+#define DPSG_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+#endif
+#ifndef DPSG_NO_UNIQUE_ADDRESS
+#define DPSG_NO_UNIQUE_ADDRESS
+#endif
+
+namespace dpsg {
+
+template <class... Ts>
+class compressed_tuple;
+
+namespace detail {
+
+// Element indices in storage order: by decreasing alignment, declaration
+// order otherwise
+template <class... Ts>
+constexpr std::array<std::size_t, sizeof...(Ts)> storage_order() noexcept {
+  constexpr std::array<std::size_t, sizeof...(Ts)> alignments{alignof(Ts)...};
+  std::array<std::size_t, sizeof...(Ts)> order{};
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    std::size_t j = i;
+    for (; j > 0 && alignments[order[j - 1]] < alignments[i]; --j) {
+      order[j] = order[j - 1];
+    }
+    order[j] = i;
+  }
+  return order;
+}
+
+template <std::size_t I, class T>
+struct compressed_leaf {
+  DPSG_NO_UNIQUE_ADDRESS T value;
+};
+
+template <class Slots, class... Ts>
+struct compressed_storage;
+
+template <std::size_t... Slots, class... Ts>
+struct compressed_storage<std::index_sequence<Slots...>, Ts...>
+    : compressed_leaf<storage_order<Ts...>()[Slots],
+                      std::tuple_element_t<storage_order<Ts...>()[Slots],
+                                           std::tuple<Ts...>>>... {};
+
+template <std::size_t I, class... Ts>
+using compressed_leaf_t =
+    compressed_leaf<I, std::tuple_element_t<I, std::tuple<Ts...>>>;
+
+// True for a single argument of type Tuple, which must go to the copy and
+// move constructors rather than become the element, as with std::tuple
+template <class Tuple, class... Us>
+constexpr static inline bool is_self_v = false;
+template <class Tuple, class U>
+constexpr static inline bool is_self_v<Tuple, U> =
+    std::is_same_v<std::remove_cv_t<std::remove_reference_t<U>>, Tuple>;
+
+}  // namespace detail
+
+template <std::size_t I, class... Ts>
+constexpr std::tuple_element_t<I, std::tuple<Ts...>>& get(
+    compressed_tuple<Ts...>& t) noexcept {
+  return static_cast<detail::compressed_leaf_t<I, Ts...>&>(t.storage_).value;
+}
+
+template <std::size_t I, class... Ts>
+constexpr const std::tuple_element_t<I, std::tuple<Ts...>>& get(
+    const compressed_tuple<Ts...>& t) noexcept {
+  return static_cast<const detail::compressed_leaf_t<I, Ts...>&>(t.storage_)
+      .value;
+}
+
+// Reference elements stay lvalue references, as with std::get
+template <std::size_t I, class... Ts>
+constexpr std::tuple_element_t<I, std::tuple<Ts...>>&& get(
+    compressed_tuple<Ts...>&& t) noexcept {
+  using element_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+  return std::forward<element_t>(
+      static_cast<detail::compressed_leaf_t<I, Ts...>&>(t.storage_).value);
+}
+
+template <class... Ts>
+class compressed_tuple {
+  using storage_t =
+      detail::compressed_storage<std::index_sequence_for<Ts...>, Ts...>;
+
+ public:
+  constexpr compressed_tuple() noexcept(
+      std::conjunction_v<std::is_nothrow_default_constructible<Ts>...>)
+      : storage_{} {}
+
+  template <class... Us,
+            std::enable_if_t<sizeof...(Us) == sizeof...(Ts) &&
+                                 sizeof...(Ts) != 0 &&
+                                 !detail::is_self_v<compressed_tuple, Us...> &&
+                                 std::conjunction_v<
+                                     std::is_constructible<Ts, Us&&>...>,
+                             int> = 0>
+  constexpr explicit compressed_tuple(Us&&... values)
+      : compressed_tuple(std::index_sequence_for<Ts...>{},
+                         std::forward_as_tuple(std::forward<Us>(values)...)) {}
+
+  template <
+      class Self,
+      class F,
+      class... Args,
+      std::enable_if_t<std::is_same_v<std::decay_t<Self>, compressed_tuple>,
+                       int> = 0>
+  constexpr friend void dpsg_traverse(Self&& self, F&& f, Args&&... args) {
+    // Large tuples go through indexed dispatch, as std::tuple does
+    detail::traverse_tuple<default_tuple_unroll_limit_t>(
+        std::forward<Self>(self), f, args...);
+  }
+
+  template <
+      class Self,
+      class A,
+      class F,
+      class... Args,
+      std::enable_if_t<std::is_same_v<std::decay_t<Self>, compressed_tuple>,
+                       int> = 0>
+  constexpr friend auto dpsg_fold(Self&& self,
+                                  A&& acc,
+                                  F&& fun,
+                                  Args&&... args) {
+    return detail::fold_tuple<default_tuple_unroll_limit_t>(
+        std::forward<Self>(self), std::forward<A>(acc), fun, args...);
+  }
+
+ private:
+  template <std::size_t... Slots, class Values>
+  constexpr compressed_tuple(
+      [[maybe_unused]] std::index_sequence<Slots...> marker,
+      Values&& values)
+      : storage_{detail::compressed_leaf_t<
+            detail::storage_order<Ts...>()[Slots],
+            Ts...>{std::get<detail::storage_order<Ts...>()[Slots]>(
+            std::move(values))}...} {}
+
+  template <std::size_t I, class... Us>
+  friend constexpr std::tuple_element_t<I, std::tuple<Us...>>& get(
+      compressed_tuple<Us...>& t) noexcept;
+  template <std::size_t I, class... Us>
+  friend constexpr const std::tuple_element_t<I, std::tuple<Us...>>& get(
+      const compressed_tuple<Us...>& t) noexcept;
+  template <std::size_t I, class... Us>
+  friend constexpr std::tuple_element_t<I, std::tuple<Us...>>&& get(
+      compressed_tuple<Us...>&& t) noexcept;
+
+  DPSG_NO_UNIQUE_ADDRESS storage_t storage_;
+};
+
+}  // namespace dpsg
+
+namespace std {
+template <class... Ts>
+struct tuple_size<dpsg::compressed_tuple<Ts...>>
+    : integral_constant<size_t, sizeof...(Ts)> {};
+
+template <size_t I, class... Ts>
+struct tuple_element<I, dpsg::compressed_tuple<Ts...>>
+    : tuple_element<I, tuple<Ts...>> {};
+}  // namespace std
+
+#endif  // GUARD_DPSG_COMPRESSED_TUPLE_HPP
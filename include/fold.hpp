@@ -8,7 +8,9 @@
 #include <variant>
 
 #include "./feed.hpp"
+#include "./is_range.hpp"
 #include "./is_template_instance.hpp"
+#include "./unroll.hpp"
 
 namespace dpsg {
 namespace customization_points {
@@ -25,20 +27,21 @@ constexpr auto fold_over(
     [[maybe_unused]] Args&&... args) /*it's actually really hard to write the
                                         correct noexcept spec here*/
 {
+  // Extra arguments are given to every step, they can't be moved from
   if constexpr (S < Count::value) {
     return fold_over<S + 1, Count>(std::forward<T>(tuple),
                                    fun(std::forward<A>(acc),
                                        std::get<S>(std::forward<T>(tuple)),
-                                       std::forward<Args>(args)...),
+                                       args...),
                                    std::forward<F>(fun),
                                    args...);
   }
   else {
-    return acc;
+    return std::forward<A>(acc);
   }
 }
 }  // namespace detail
-#if defined(_cpp_concepts)
+#if defined(__cpp_concepts)
 template <template_instance_of<std::tuple> T, class A, class F, class... Args>
 #else
 template <class T,
@@ -54,14 +57,22 @@ dpsg_fold(T&& tuple, A&& acc, F&& fun, Args&&... extra) noexcept(
         std::forward<A>(acc),
         std::forward<F>(fun),
         std::forward<Args>(extra)...))) {
-  return detail::fold_over<0, feed_t<T, detail::parameter_count>>(
-      std::forward<T>(tuple),
-      std::forward<A>(acc),
-      std::forward<F>(fun),
-      std::forward<Args>(extra)...);
+  if constexpr (std::tuple_size_v<std::decay_t<T>> <=
+                default_tuple_unroll_limit_t::value) {
+    return detail::fold_over<0, feed_t<T, detail::parameter_count>>(
+        std::forward<T>(tuple),
+        std::forward<A>(acc),
+        std::forward<F>(fun),
+        std::forward<Args>(extra)...);
+  }
+  else {
+    // Large tuples may go through indexed dispatch, see unroll.hpp
+    return dpsg::detail::fold_tuple<default_tuple_unroll_limit_t>(
+        std::forward<T>(tuple), std::forward<A>(acc), fun, extra...);
+  }
 }
 
-#if defined(_cpp_concepts)
+#if defined(__cpp_concepts)
 template <template_instance_of<std::variant> T, class A, class F, class... Args>
 #else
 template <class T,
@@ -84,7 +95,7 @@ constexpr decltype(auto) dpsg_fold(
       variant);
 }
 
-#if defined(_cpp_concepts)
+#if defined(__cpp_concepts)
 template <template_instance_of<std::pair> T, class A, class F, class... Args>
 #else
 template <class T,
@@ -103,7 +114,7 @@ dpsg_fold(T&& pair, A&& acc, F&& fun, Args&&... extra) noexcept(noexcept(
              extra...);
 }
 
-#if defined(_cpp_concepts)
+#if defined(__cpp_concepts)
 template <template_instance_of<std::optional> T,
           class A,
           class F,
@@ -128,10 +139,28 @@ dpsg_fold(T&& option, A&& acc, F&& fun, Args&&... extra) noexcept(
         std::forward<A>(acc), *std::forward<T>(option), extra...);
   }
   else {
-    return acc;
+    return std::forward<A>(acc);
   }
 }
 
+// String literals are text, see is_range.hpp
+#if defined(__cpp_concepts)
+template <fixed_size_array T, class A, class F, class... Args>
+requires(!dpsg::detail::is_text_v<T>)
+#else
+template <class T,
+          class A,
+          class F,
+          class... Args,
+          std::enable_if_t<is_fixed_size_array_v<T> &&
+                               !dpsg::detail::is_text_v<T>,
+                           int> = 0>
+#endif
+constexpr auto dpsg_fold(T&& array, A&& acc, F&& fun, Args&&... extra) {
+  return dpsg::detail::fold_array<default_unroll_limit_t>(
+      std::forward<T>(array), std::forward<A>(acc), fun, extra...);
+}
+
 }  // namespace customization_points
 
 namespace detail {
@@ -147,15 +176,40 @@ struct {
 } constexpr static inline ignore_fold;
 
 template <class T, typename Acc, class = void>
-struct is_foldable : std::false_type {};
+struct has_dpsg_fold : std::false_type {};
 
 template <class T, typename Acc>
-struct is_foldable<
+struct has_dpsg_fold<
     T,
     Acc,
     std::void_t<decltype(
         dpsg_fold(std::declval<T>(), std::declval<Acc>(), ignore_fold))>>
     : std::true_type {};
+
+// Other ranges are folded with a loop, as a fallback that never competes with
+// a customization (see traverse.hpp)
+template <class T, typename Acc>
+constexpr static inline bool is_loop_foldable_v =
+    is_range_v<T> && !is_text_v<T> &&
+    !has_dpsg_fold<T, Acc>::value;
+
+template <class T, typename Acc>
+struct is_foldable : std::bool_constant<has_dpsg_fold<T, Acc>::value ||
+                                        is_loop_foldable_v<T, Acc>> {};
+
+// The type of the accumulator is fixed by the initial value for ranges, since
+// they may be empty
+template <class T, class A, class F, class... Args>
+constexpr std::decay_t<A> fold_range(T& range,
+                                     A&& acc,
+                                     F& fun,
+                                     Args&... extra) {
+  std::decay_t<A> result = std::forward<A>(acc);
+  for (auto&& element : range) {
+    result = fun(std::move(result), element, extra...);
+  }
+  return result;
+}
 }  // namespace detail
 
 template <class T, class Acc = detail::arbitrary>
@@ -165,10 +219,24 @@ constexpr static inline bool is_foldable_v = is_foldable<T, Acc>::value;
 
 #if defined(__cpp_concepts)
 template <class T, class Acc = detail::arbitrary>
-concept foldable = is_foldable_v<std::decay_t<T>, Acc>;
+concept foldable =
+    is_foldable_v<std::remove_cv_t<std::remove_reference_t<T>>, Acc>;
 #endif
 
 namespace detail {
+template <class T, class A, class F, class... Args>
+constexpr bool is_nothrow_customized_fold() noexcept {
+  if constexpr (has_dpsg_fold<T, A>::value) {
+    return noexcept(dpsg_fold(std::declval<T>(),
+                              std::declval<A>(),
+                              std::declval<F>(),
+                              std::declval<Args>()...));
+  }
+  else {
+    return false;
+  }
+}
+
 struct fold_t {
 #if defined(__cpp_concepts)
   template <class A, foldable<A> T, class F, class... Args>
@@ -177,20 +245,24 @@ struct fold_t {
             class F,
             class A,
             class... Args,
-            std::enable_if_t<is_foldable_v<std::decay_t<T>, A>, int> = 0>
+            std::enable_if_t<
+                is_foldable_v<std::remove_cv_t<std::remove_reference_t<T>>, A>,
+                int> = 0>
 #endif
   constexpr decltype(auto) operator()(T&& foldable,
                                       A&& acc,
                                       F&& fun,
                                       Args&&... extra) const
-      noexcept(noexcept(dpsg_fold(std::forward<T>(foldable),
-                                  std::forward<A>(acc),
-                                  std::forward<F>(fun),
-                                  std::forward<Args>(extra)...))) {
-    return dpsg_fold(std::forward<T>(foldable),
-                     std::forward<A>(acc),
-                     std::forward<F>(fun),
-                     std::forward<Args>(extra)...);
+      noexcept(is_nothrow_customized_fold<T, A, F, Args...>()) {
+    if constexpr (has_dpsg_fold<T, A>::value) {
+      return dpsg_fold(std::forward<T>(foldable),
+                       std::forward<A>(acc),
+                       std::forward<F>(fun),
+                       std::forward<Args>(extra)...);
+    }
+    else {
+      return fold_range(foldable, std::forward<A>(acc), fun, extra...);
+    }
   }
 };
 
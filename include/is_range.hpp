@@ -0,0 +1,117 @@
+#ifndef GUARD_DPSG_IS_RANGE_HPP
+#define GUARD_DPSG_IS_RANGE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/* template<class T> bool is_range_v;
+
+    Detects types that can be iterated over with a range-based for loop, i.e.
+   for which begin and end are found on an lvalue, either as members or through
+   argument dependent lookup. detail::adl_begin and detail::adl_end perform the
+   same lookup.
+
+    Example:
+
+        #include <map>
+        #include <tuple>
+        #include <vector>
+
+        static_assert(dpsg::is_range_v<std::vector<int>>);
+        static_assert(dpsg::is_range_v<const std::map<int, char>&>);
+        static_assert(dpsg::is_range_v<int[3]>);
+        static_assert(!dpsg::is_range_v<std::tuple<int, int>>);
+
+    If you have access to C++20, a concept named iterable is provided.
+
+    detail::is_text_v tells apart strings, string views and C arrays of
+   characters (string literals). They are text rather than containers, and
+   dpsg::traverse and dpsg::fold don't iterate over them.
+*/
+
+namespace dpsg {
+
+namespace detail {
+namespace adl {
+using std::begin;
+using std::end;
+
+template <class T>
+constexpr auto adl_begin(T& range) -> decltype(begin(range)) {
+  return begin(range);
+}
+template <class T>
+constexpr auto adl_end(T& range) -> decltype(end(range)) {
+  return end(range);
+}
+}  // namespace adl
+using adl::adl_begin;
+using adl::adl_end;
+
+template <class T, class = void>
+struct is_range : std::false_type {};
+
+template <class T>
+struct is_range<T,
+                std::void_t<decltype(adl_begin(std::declval<T&>())),
+                            decltype(adl_end(std::declval<T&>()))>>
+    : std::true_type {};
+
+// Ranges whose elements are stored next to each other, as far as std::data
+// and std::size can tell
+template <class T, class = void>
+struct is_contiguous_range : std::false_type {};
+template <class T>
+struct is_contiguous_range<T,
+                           std::void_t<decltype(std::data(std::declval<T&>())),
+                                       decltype(std::size(std::declval<T&>()))>>
+    : std::true_type {};
+
+template <class T>
+struct is_character : std::false_type {};
+template <>
+struct is_character<char> : std::true_type {};
+template <>
+struct is_character<wchar_t> : std::true_type {};
+#if defined(__cpp_char8_t)
+template <>
+struct is_character<char8_t> : std::true_type {};
+#endif
+template <>
+struct is_character<char16_t> : std::true_type {};
+template <>
+struct is_character<char32_t> : std::true_type {};
+
+// std::basic_string, std::basic_string_view and C arrays of characters
+template <class T>
+struct is_text : std::false_type {};
+template <class C, class Traits, class Alloc>
+struct is_text<std::basic_string<C, Traits, Alloc>> : is_character<C> {};
+template <class C, class Traits>
+struct is_text<std::basic_string_view<C, Traits>> : is_character<C> {};
+template <class C, std::size_t N>
+struct is_text<C[N]> : is_character<std::remove_cv_t<C>> {};
+
+template <class T>
+constexpr static inline bool is_text_v =
+    is_text<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+}  // namespace detail
+
+template <class T>
+using is_range = detail::is_range<std::remove_reference_t<T>>;
+
+template <class T>
+constexpr static inline bool is_range_v = is_range<T>::value;
+
+#if defined(__cpp_concepts)
+template <class T>
+concept iterable = is_range_v<T>;
+#endif
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_IS_RANGE_HPP
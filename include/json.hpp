@@ -0,0 +1,826 @@
+#ifndef GUARD_DPSG_JSON_HPP
+#define GUARD_DPSG_JSON_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "./composite.hpp"
+#include "./is_range.hpp"
+#include "./is_template_instance.hpp"
+#include "./traverse.hpp"
+
+/* write_result dpsg::json::write(char* first, char* last, const T& value);
+   read_result dpsg::json::read(const char* first, const char* last, T& value);
+
+    Streaming JSON encoder and pull parser driven by the static shape of the
+   types. Neither builds an intermediate document: write() goes straight into
+   a caller provided buffer and never allocates, read() parses directly into
+   the target object (which may of course allocate for its own storage, when
+   growing a std::vector or a std::string for instance).
+
+    The mapping is the following:
+        - bool: true or false
+        - integral and floating point types: numbers (char is a number too)
+        - std::string, std::string_view, const char* and char arrays:
+          strings. Only std::string can be read.
+        - std::nullptr_t and std::monostate: null
+        - std::optional<T>: null, or the value
+        - std::variant<Ts...>: [index, value]
+        - types for which dpsg_json_fields(const T&) is found through ADL:
+          objects. The function returns the names of the elements in the
+          order in which they are traversed, e.g. a std::array of
+          std::string_view. When reading, members may come in any order,
+          unknown ones are skipped and missing ones leave their element
+          untouched.
+        - anything else traversable (tuples, pairs, arrays, ranges,
+          user-defined traversables): arrays, in traversal order. Ranges that
+          support push_back or insert are cleared then filled when read.
+   Composites are not supported, their visitors don't deal in elements.
+
+        struct point {
+          int x;
+          int y;
+          template <class Self, class F> ... dpsg_traverse(Self& p, F&& f)
+        };
+        constexpr std::array<std::string_view, 2> dpsg_json_fields(
+            const point&) { return {"x", "y"}; }
+
+        char buffer[256];
+        auto [end, ec] = dpsg::json::write(buffer, buffer + 256, point{1, 2});
+        // {"x":1,"y":2}
+
+        point p;
+        auto [ptr, ec2] = dpsg::json::read(buffer, end, p);
+
+    Errors are reported like std::to_chars and std::from_chars do:
+        - write: std::errc::value_too_large if the buffer is too small,
+          std::errc::invalid_argument for non finite floating point numbers.
+        - read: std::errc::invalid_argument for malformed input or input that
+          doesn't match the shape of the target, std::errc::result_out_of_range
+          for numbers that don't fit in their target.
+   On error, ptr points where the problem was found. The target object may be
+   left partially updated.
+*/
+
+namespace dpsg::json {
+
+struct write_result {
+  char* ptr;
+  std::errc ec;
+};
+
+struct read_result {
+  const char* ptr;
+  std::errc ec;
+};
+
+namespace detail {
+
+template <class T>
+using bare_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <class T, class = void>
+struct has_fields : std::false_type {};
+template <class T>
+struct has_fields<
+    T,
+    std::void_t<decltype(dpsg_json_fields(std::declval<const T&>()))>>
+    : std::true_type {};
+
+template <class T>
+constexpr static inline bool is_string_v =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+    (std::is_array_v<T> &&
+     std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>);
+
+template <class T>
+constexpr static inline bool is_null_v =
+    std::is_same_v<T, std::nullptr_t> || std::is_same_v<T, std::monostate>;
+
+template <class T, class = void>
+struct has_push_back : std::false_type {};
+template <class T>
+struct has_push_back<T,
+                     std::void_t<decltype(std::declval<T&>().push_back(
+                         std::declval<typename T::value_type>()))>>
+    : std::true_type {};
+
+template <class T, class = void>
+struct has_insert : std::false_type {};
+template <class T>
+struct has_insert<T,
+                  std::void_t<decltype(std::declval<T&>().insert(
+                      std::declval<typename T::value_type>()))>>
+    : std::true_type {};
+
+// Elements of maps are std::pair<const K, V>, which can't be read in place
+template <class T>
+struct readable {
+  using type = T;
+};
+template <class K, class V>
+struct readable<std::pair<const K, V>> {
+  using type = std::pair<K, V>;
+};
+
+class writer {
+ public:
+  constexpr writer(char* first, char* last) noexcept
+      : current_{first}, last_{last} {}
+
+  template <class T>
+  void value(const T& v) {
+    using V = bare_t<T>;
+    // Nothing is written past the first error, so that ptr stays on it
+    if (failed()) {
+      return;
+    }
+    if constexpr (std::is_same_v<V, bool>) {
+      raw(v ? std::string_view{"true"} : std::string_view{"false"});
+    }
+    else if constexpr (std::is_arithmetic_v<V>) {
+      number(v);
+    }
+    else if constexpr (is_string_v<V>) {
+      string(std::string_view{v});
+    }
+    else if constexpr (is_null_v<V>) {
+      raw("null");
+    }
+    else if constexpr (is_template_instance_v<V, std::optional>) {
+      if (v) {
+        value(*v);
+      }
+      else {
+        raw("null");
+      }
+    }
+    else if constexpr (is_template_instance_v<V, std::variant>) {
+      put('[');
+      number(v.index());
+      put(',');
+      std::visit([this](const auto& alternative) { value(alternative); }, v);
+      put(']');
+    }
+    else if constexpr (has_fields<V>::value) {
+      object(v);
+    }
+    else if constexpr (is_composite_v<V>) {
+      static_assert(!is_composite_v<V>,
+                    "dpsg::json doesn't support composites");
+    }
+    else if constexpr (is_traversable_v<const V&>) {
+      put('[');
+      bool first = true;
+      dpsg::traverse(v, [this, &first](const auto& element) {
+        if (!first) {
+          put(',');
+        }
+        first = false;
+        value(element);
+      });
+      put(']');
+    }
+    else {
+      static_assert(is_traversable_v<const V&>,
+                    "dpsg::json can't represent this type");
+    }
+  }
+
+  [[nodiscard]] write_result result() const noexcept {
+    return {current_, error_};
+  }
+
+ private:
+  void fail(std::errc error) noexcept {
+    if (error_ == std::errc{}) {
+      error_ = error;
+    }
+  }
+
+  [[nodiscard]] bool failed() const noexcept { return error_ != std::errc{}; }
+
+  void put(char c) noexcept {
+    if (failed()) {
+      return;
+    }
+    if (current_ == last_) {
+      fail(std::errc::value_too_large);
+      return;
+    }
+    *current_++ = c;
+  }
+
+  void raw(std::string_view text) noexcept {
+    if (failed()) {
+      return;
+    }
+    if (static_cast<std::size_t>(last_ - current_) < text.size()) {
+      fail(std::errc::value_too_large);
+      return;
+    }
+    current_ = std::copy(text.begin(), text.end(), current_);
+  }
+
+  template <class N>
+  void number(N n) noexcept {
+    if (failed()) {
+      return;
+    }
+    if constexpr (std::is_floating_point_v<N>) {
+      if (!std::isfinite(n)) {
+        fail(std::errc::invalid_argument);
+        return;
+      }
+    }
+    auto [ptr, ec] = std::to_chars(current_, last_, n);
+    if (ec != std::errc{}) {
+      fail(ec);
+      return;
+    }
+    current_ = ptr;
+  }
+
+  void string(std::string_view s) noexcept {
+    constexpr char hex[] = "0123456789abcdef";
+    put('"');
+    for (char c : s) {
+      switch (c) {
+        case '"':
+          raw("\\\"");
+          break;
+        case '\\':
+          raw("\\\\");
+          break;
+        case '\n':
+          raw("\\n");
+          break;
+        case '\r':
+          raw("\\r");
+          break;
+        case '\t':
+          raw("\\t");
+          break;
+        case '\b':
+          raw("\\b");
+          break;
+        case '\f':
+          raw("\\f");
+          break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20) {
+            const char escaped[] = {'\\',
+                                    'u',
+                                    '0',
+                                    '0',
+                                    hex[(c >> 4) & 0xF],
+                                    hex[c & 0xF]};
+            raw(std::string_view{escaped, sizeof(escaped)});
+          }
+          else {
+            put(c);
+          }
+      }
+    }
+    put('"');
+  }
+
+  template <class T>
+  void object(const T& v) {
+    const auto& names = dpsg_json_fields(v);
+    auto name = std::begin(names);
+    put('{');
+    bool first = true;
+    dpsg::traverse(v, [this, &first, &name](const auto& element) {
+      if (!first) {
+        put(',');
+      }
+      first = false;
+      string(*name++);
+      put(':');
+      value(element);
+    });
+    put('}');
+  }
+
+  char* current_;
+  char* last_;
+  std::errc error_{};
+};
+
+class reader {
+ public:
+  constexpr reader(const char* first, const char* last) noexcept
+      : current_{first}, last_{last} {}
+
+  template <class T>
+  void value(T& v) {
+    using V = bare_t<T>;
+    if (failed()) {
+      return;
+    }
+    skip_whitespace();
+    if constexpr (std::is_same_v<V, bool>) {
+      if (literal("true")) {
+        v = true;
+      }
+      else if (literal("false")) {
+        v = false;
+      }
+      else {
+        fail(std::errc::invalid_argument);
+      }
+    }
+    else if constexpr (std::is_arithmetic_v<V>) {
+      number(v);
+    }
+    else if constexpr (std::is_same_v<V, std::string>) {
+      string(v);
+    }
+    else if constexpr (is_null_v<V>) {
+      if (!literal("null")) {
+        fail(std::errc::invalid_argument);
+      }
+    }
+    else if constexpr (is_template_instance_v<V, std::optional>) {
+      if (literal("null")) {
+        v.reset();
+      }
+      else {
+        if (!v) {
+          v.emplace();
+        }
+        value(*v);
+      }
+    }
+    else if constexpr (is_template_instance_v<V, std::variant>) {
+      variant(v);
+    }
+    else if constexpr (has_fields<V>::value) {
+      object(v);
+    }
+    else if constexpr (is_composite_v<V>) {
+      static_assert(!is_composite_v<V>,
+                    "dpsg::json doesn't support composites");
+    }
+    else if constexpr (is_range_v<V> && !is_fixed_size_array_v<V> &&
+                       (has_push_back<V>::value || has_insert<V>::value)) {
+      container(v);
+    }
+    else if constexpr (is_traversable_v<V&>) {
+      expect('[');
+      bool first = true;
+      dpsg::traverse(v, [this, &first](auto& element) {
+        if (!first) {
+          expect(',');
+        }
+        first = false;
+        value(element);
+      });
+      expect(']');
+    }
+    else {
+      static_assert(is_traversable_v<V&>,
+                    "dpsg::json can't read this type, or it isn't traversable "
+                    "through a non-const reference");
+    }
+  }
+
+  [[nodiscard]] read_result result() noexcept {
+    if (!failed()) {
+      skip_whitespace();
+    }
+    return {current_, error_};
+  }
+
+ private:
+  [[nodiscard]] bool failed() const noexcept { return error_ != std::errc{}; }
+
+  void fail(std::errc error) noexcept {
+    if (!failed()) {
+      error_ = error;
+    }
+  }
+
+  void skip_whitespace() noexcept {
+    while (current_ != last_ && (*current_ == ' ' || *current_ == '\n' ||
+                                 *current_ == '\r' || *current_ == '\t')) {
+      ++current_;
+    }
+  }
+
+  // Consumes c if it is the next significant character
+  bool accept(char c) noexcept {
+    if (failed()) {
+      return false;
+    }
+    skip_whitespace();
+    if (current_ != last_ && *current_ == c) {
+      ++current_;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) noexcept {
+    if (!accept(c)) {
+      fail(std::errc::invalid_argument);
+    }
+  }
+
+  bool literal(std::string_view text) noexcept {
+    if (static_cast<std::size_t>(last_ - current_) >= text.size() &&
+        std::string_view{current_, text.size()} == text) {
+      current_ += text.size();
+      return true;
+    }
+    return false;
+  }
+
+  // End of the characters that may be part of a number
+  [[nodiscard]] const char* number_end() const noexcept {
+    const char* end = current_;
+    while (end != last_ && ((*end >= '0' && *end <= '9') || *end == '-' ||
+                            *end == '+' || *end == '.' || *end == 'e' ||
+                            *end == 'E')) {
+      ++end;
+    }
+    return end;
+  }
+
+  template <class N>
+  void number(N& n) noexcept {
+    const char* const end = number_end();
+    auto [ptr, ec] = std::from_chars(current_, end, n);
+    if (ec != std::errc{}) {
+      fail(ec);
+      return;
+    }
+    if (ptr != end) {
+      fail(std::errc::invalid_argument);
+      return;
+    }
+    current_ = ptr;
+  }
+
+  bool hex_digits(std::uint32_t& code) noexcept {
+    if (last_ - current_ < 4) {
+      return false;
+    }
+    code = 0;
+    for (int i = 0; i < 4; ++i) {
+      char c = *current_++;
+      code <<= 4;
+      if (c >= '0' && c <= '9') {
+        code |= static_cast<std::uint32_t>(c - '0');
+      }
+      else if (c >= 'a' && c <= 'f') {
+        code |= static_cast<std::uint32_t>(c - 'a' + 10);
+      }
+      else if (c >= 'A' && c <= 'F') {
+        code |= static_cast<std::uint32_t>(c - 'A' + 10);
+      }
+      else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void append_utf8(std::string& out, std::uint32_t code) {
+    if (code < 0x80) {
+      out.push_back(static_cast<char>(code));
+    }
+    else if (code < 0x800) {
+      out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    else if (code < 0x10000) {
+      out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    else {
+      out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+  }
+
+  bool escape(std::string& out) {
+    if (current_ == last_) {
+      return false;
+    }
+    switch (*current_++) {
+      case '"':
+        out.push_back('"');
+        return true;
+      case '\\':
+        out.push_back('\\');
+        return true;
+      case '/':
+        out.push_back('/');
+        return true;
+      case 'b':
+        out.push_back('\b');
+        return true;
+      case 'f':
+        out.push_back('\f');
+        return true;
+      case 'n':
+        out.push_back('\n');
+        return true;
+      case 'r':
+        out.push_back('\r');
+        return true;
+      case 't':
+        out.push_back('\t');
+        return true;
+      case 'u': {
+        std::uint32_t code{};
+        if (!hex_digits(code)) {
+          return false;
+        }
+        if (code >= 0xD800 && code < 0xDC00) {
+          std::uint32_t low{};
+          if (!literal("\\u") || !hex_digits(low) || low < 0xDC00 ||
+              low >= 0xE000) {
+            return false;
+          }
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (code >= 0xDC00 && code < 0xE000) {
+          // A low surrogate must follow a high one
+          return false;
+        }
+        append_utf8(out, code);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  void string(std::string& out) {
+    if (!accept('"')) {
+      fail(std::errc::invalid_argument);
+      return;
+    }
+    out.clear();
+    while (current_ != last_) {
+      // Copies unescaped runs in one go
+      const char* run = current_;
+      while (current_ != last_ && *current_ != '"' && *current_ != '\\' &&
+             static_cast<unsigned char>(*current_) >= 0x20) {
+        ++current_;
+      }
+      out.append(run, current_);
+      if (current_ == last_) {
+        break;
+      }
+      if (*current_ == '"') {
+        ++current_;
+        return;
+      }
+      if (*current_ != '\\') {
+        break;
+      }
+      ++current_;
+      if (!escape(out)) {
+        break;
+      }
+    }
+    fail(std::errc::invalid_argument);
+  }
+
+  // Keys without escapes are compared in place, the others are unescaped
+  // into buffer first
+  std::string_view key(std::string& buffer) {
+    if (!accept('"')) {
+      fail(std::errc::invalid_argument);
+      return {};
+    }
+    const char* const first = current_;
+    while (current_ != last_ && *current_ != '"' && *current_ != '\\' &&
+           static_cast<unsigned char>(*current_) >= 0x20) {
+      ++current_;
+    }
+    if (current_ != last_ && *current_ == '"') {
+      ++current_;
+      return {first, static_cast<std::size_t>(current_ - first - 1)};
+    }
+    current_ = first - 1;
+    string(buffer);
+    return buffer;
+  }
+
+  void skip_string() noexcept {
+    if (!accept('"')) {
+      fail(std::errc::invalid_argument);
+      return;
+    }
+    while (current_ != last_ && *current_ != '"' &&
+           static_cast<unsigned char>(*current_) >= 0x20) {
+      if (*current_++ != '\\') {
+        continue;
+      }
+      std::uint32_t code{};
+      if (current_ == last_ ||
+          std::string_view{"\"\\/bfnrtu"}.find(*current_) ==
+              std::string_view::npos ||
+          (*current_++ == 'u' && !hex_digits(code))) {
+        fail(std::errc::invalid_argument);
+        return;
+      }
+    }
+    if (current_ == last_ || *current_ != '"') {
+      fail(std::errc::invalid_argument);
+      return;
+    }
+    ++current_;
+  }
+
+  void skip_number() noexcept {
+    const char* const end = number_end();
+    double ignored{};
+    // Numbers too large for a double are valid JSON all the same
+    auto [ptr, ec] = std::from_chars(current_, end, ignored);
+    if ((ec != std::errc{} && ec != std::errc::result_out_of_range) ||
+        ptr != end) {
+      fail(std::errc::invalid_argument);
+      return;
+    }
+    current_ = end;
+  }
+
+  // Checks and skips a value of any type, for unknown object members
+  void skip_value() noexcept {
+    if (failed()) {
+      return;
+    }
+    skip_whitespace();
+    if (current_ == last_) {
+      fail(std::errc::invalid_argument);
+    }
+    else if (*current_ == '"') {
+      skip_string();
+    }
+    else if (accept('[')) {
+      if (!accept(']')) {
+        do {
+          skip_value();
+        } while (accept(','));
+        expect(']');
+      }
+    }
+    else if (accept('{')) {
+      if (!accept('}')) {
+        do {
+          skip_string();
+          expect(':');
+          skip_value();
+        } while (accept(','));
+        expect('}');
+      }
+    }
+    else if (!literal("true") && !literal("false") && !literal("null")) {
+      skip_number();
+    }
+  }
+
+  template <class V, std::size_t... Is>
+  void variant_alternative(V& v,
+                           std::size_t index,
+                           [[maybe_unused]] std::index_sequence<Is...> seq) {
+    bool found = ((index == Is ? (read_alternative<Is>(v), true) : false) ||
+                  ...);
+    if (!found) {
+      fail(std::errc::invalid_argument);
+    }
+  }
+
+  template <std::size_t I, class V>
+  void read_alternative(V& v) {
+    if (v.index() != I) {
+      v.template emplace<I>();
+    }
+    value(std::get<I>(v));
+  }
+
+  template <class V>
+  void variant(V& v) {
+    expect('[');
+    std::size_t index{};
+    value(index);
+    expect(',');
+    if (!failed()) {
+      variant_alternative(
+          v, index, std::make_index_sequence<std::variant_size_v<V>>{});
+    }
+    expect(']');
+  }
+
+  // Reads the element given at position index by the traversal of v
+  template <class T>
+  void member(T& v, std::size_t index) {
+    std::size_t i = 0;
+    dpsg::traverse(v, [this, &i, index](auto& element) {
+      if (i++ == index) {
+        value(element);
+      }
+    });
+  }
+
+  // Members come in any order, unknown ones are skipped
+  template <class T>
+  void object(T& v) {
+    const auto& names = dpsg_json_fields(std::as_const(v));
+    expect('{');
+    if (failed() || accept('}')) {
+      return;
+    }
+    std::string buffer;
+    do {
+      const std::string_view name = key(buffer);
+      expect(':');
+      if (failed()) {
+        return;
+      }
+      const auto found =
+          std::find_if(std::begin(names),
+                       std::end(names),
+                       [name](const auto& field) {
+                         return std::string_view{field} == name;
+                       });
+      if (found == std::end(names)) {
+        skip_value();
+      }
+      else {
+        member(v,
+               static_cast<std::size_t>(
+                   std::distance(std::begin(names), found)));
+      }
+    } while (accept(','));
+    expect('}');
+  }
+
+  template <class C>
+  void container(C& c) {
+    expect('[');
+    c.clear();
+    if (accept(']')) {
+      return;
+    }
+    do {
+      typename readable<typename C::value_type>::type element{};
+      value(element);
+      if (failed()) {
+        return;
+      }
+      if constexpr (has_push_back<C>::value) {
+        c.push_back(std::move(element));
+      }
+      else {
+        c.insert(std::move(element));
+      }
+    } while (accept(','));
+    expect(']');
+  }
+
+  const char* current_;
+  const char* last_;
+  std::errc error_{};
+};
+
+}  // namespace detail
+
+template <class T>
+write_result write(char* first, char* last, const T& value) {
+  detail::writer w{first, last};
+  w.value(value);
+  return w.result();
+}
+
+template <class T>
+read_result read(const char* first, const char* last, T& value) {
+  detail::reader r{first, last};
+  r.value(value);
+  return r.result();
+}
+
+}  // namespace dpsg::json
+
+#endif  // GUARD_DPSG_JSON_HPP
@@ -0,0 +1,291 @@
+#ifndef GUARD_DPSG_MULTI_FOLD_HPP
+#define GUARD_DPSG_MULTI_FOLD_HPP
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./composite.hpp"
+#include "./fold.hpp"
+#include "./is_range.hpp"
+#include "./traverse.hpp"
+
+/* template<class T, class... Reductions>
+   std::tuple<...> multi_fold(T&& foldable, Reductions&&... reductions);
+
+    Several folds computed in a single pass: each reduction pairs an initial
+   accumulator with a folding function, and the result holds the final value
+   of every accumulator, in the order of the reductions.
+
+        auto [count, total, low, high] = dpsg::multi_fold(
+            samples,
+            dpsg::reductions::count(),
+            dpsg::reductions::sum(0.0),
+            dpsg::reductions::minimum(infinity),
+            dpsg::reductions::maximum(-infinity));
+
+        auto [words, letters] = dpsg::multi_fold(
+            document,
+            dpsg::reduce(0, [](int acc, const auto& node) { ... }),
+            dpsg::reduce(0, [](int acc, const auto& node) { ... }));
+
+    Tuples, arrays, ranges and anything else dpsg::fold supports are folded
+   with dpsg::fold, so the accumulators of a tuple may change type from one
+   element to the next, and strings are rejected whatever the reductions.
+   Composites are walked in pre-order with dpsg::traverse, every node being
+   given to every reduction, and their accumulators must keep their type.
+
+    dpsg::reduce(init, fun, combine, identity) declares that fun can be
+   split: partial results can be merged with combine, and identity is an
+   accumulator that doesn't change a result it is combined with. When every
+   reduction can be split and the range is contiguous, the elements are
+   spread over DPSG_MULTI_FOLD_LANES independent accumulators (8 unless
+   defined before including this header), merged at the end. This breaks the
+   dependency of each step on the previous one and lets the compiler
+   vectorize the loop. Elements are then not given to fun in order: splitting
+   assumes that fun is associative and commutative, which floating point
+   additions are only up to rounding. The reductions of dpsg::reductions
+   (count, sum, minimum, maximum) can all be split.
+
+    benchmarks/multi_fold.cpp: count, sum, minimum and maximum of 2^18 floats.
+   Four calls to dpsg::fold: 1.00x, a multi_fold with lambdas that can't be
+   split: 0.40x, the same reductions from dpsg::reductions: 0.21x (0.28x over
+   2^24 floats, where memory bandwidth becomes the limit).
+*/
+
+#ifndef DPSG_MULTI_FOLD_LANES
+#define DPSG_MULTI_FOLD_LANES 8
+#endif
+
+namespace dpsg {
+
+template <class A, class F>
+struct reduction {
+  A init;
+  F fun;
+};
+
+template <class A, class F, class C>
+struct split_reduction : reduction<A, F> {
+  C combine;
+  A identity;
+};
+
+namespace detail {
+
+struct reduce_t {
+  template <class A, class F>
+  constexpr reduction<std::decay_t<A>, std::decay_t<F>> operator()(
+      A&& init,
+      F&& fun) const {
+    return {std::forward<A>(init), std::forward<F>(fun)};
+  }
+
+  template <class A, class F, class C>
+  constexpr split_reduction<std::decay_t<A>,
+                            std::decay_t<F>,
+                            std::decay_t<C>>
+  operator()(A&& init, F&& fun, C&& combine, std::decay_t<A> identity) const {
+    return {{std::forward<A>(init), std::forward<F>(fun)},
+            std::forward<C>(combine),
+            std::move(identity)};
+  }
+};
+
+}  // namespace detail
+
+constexpr static inline detail::reduce_t reduce{};
+
+namespace reductions {
+
+namespace detail {
+struct increment {
+  template <class A, class T>
+  constexpr A operator()(A acc, [[maybe_unused]] const T& element) const {
+    return acc + 1;
+  }
+};
+
+struct add {
+  template <class A, class T>
+  constexpr A operator()(A acc, const T& element) const {
+    return static_cast<A>(acc + element);
+  }
+};
+
+struct keep_min {
+  template <class A, class T>
+  constexpr A operator()(A acc, const T& element) const {
+    return element < acc ? static_cast<A>(element) : acc;
+  }
+};
+
+struct keep_max {
+  template <class A, class T>
+  constexpr A operator()(A acc, const T& element) const {
+    return acc < element ? static_cast<A>(element) : acc;
+  }
+};
+}  // namespace detail
+
+template <class A = std::size_t>
+constexpr auto count(A init = A{}) {
+  return dpsg::reduce(init, detail::increment{}, detail::add{}, A{});
+}
+
+template <class A>
+constexpr auto sum(A init = A{}) {
+  return dpsg::reduce(init, detail::add{}, detail::add{}, A{});
+}
+
+// The initial value is the result for an empty structure
+template <class A>
+constexpr auto minimum(A init) {
+  return dpsg::reduce(init, detail::keep_min{}, detail::keep_min{}, init);
+}
+
+template <class A>
+constexpr auto maximum(A init) {
+  return dpsg::reduce(init, detail::keep_max{}, detail::keep_max{}, init);
+}
+
+}  // namespace reductions
+
+namespace detail {
+
+template <class R>
+struct is_split_reduction : std::false_type {};
+template <class A, class F, class C>
+struct is_split_reduction<split_reduction<A, F, C>> : std::true_type {};
+
+// Applies every reduction to an element, the accumulators being a tuple
+template <class... Rs>
+struct multi_step {
+  const std::tuple<Rs...>* reductions;
+
+  template <class Acc, class E>
+  constexpr auto operator()(Acc&& acc, const E& element) const {
+    return step(std::forward<Acc>(acc),
+                element,
+                std::index_sequence_for<Rs...>{});
+  }
+
+ private:
+  template <class Acc, class E, std::size_t... Is>
+  constexpr auto step(
+      Acc&& acc,
+      const E& element,
+      [[maybe_unused]] std::index_sequence<Is...> marker) const {
+    // Spelled out: deduction would unwrap a single accumulator that is
+    // itself a tuple or a pair
+    return std::tuple<std::decay_t<decltype(std::get<Is>(*reductions).fun(
+        std::get<Is>(std::forward<Acc>(acc)), element))>...>{
+        std::get<Is>(*reductions)
+            .fun(std::get<Is>(std::forward<Acc>(acc)), element)...};
+  }
+};
+
+// Each reduction gets its own array of accumulators, one per lane, so that
+// the loop over the lanes can be vectorized
+template <std::size_t Lanes, class E, class... Rs, std::size_t... Is>
+constexpr auto fold_lanes(const E* data,
+                          std::size_t size,
+                          const std::tuple<Rs...>& rs,
+                          [[maybe_unused]] std::index_sequence<Is...> marker) {
+  std::tuple<std::array<decltype(Rs::init), Lanes>...> lanes{};
+  (
+      [&] {
+        auto& lane = std::get<Is>(lanes);
+        lane[0] = std::get<Is>(rs).init;
+        for (std::size_t k = 1; k < Lanes; ++k) {
+          lane[k] = std::get<Is>(rs).identity;
+        }
+      }(),
+      ...);
+
+  std::size_t i = 0;
+  for (; i + Lanes <= size; i += Lanes) {
+    (
+        [&] {
+          auto& lane = std::get<Is>(lanes);
+          const auto& fun = std::get<Is>(rs).fun;
+          for (std::size_t k = 0; k < Lanes; ++k) {
+            lane[k] = fun(lane[k], data[i + k]);
+          }
+        }(),
+        ...);
+  }
+  for (; i < size; ++i) {
+    ((std::get<Is>(lanes)[0] =
+          std::get<Is>(rs).fun(std::get<Is>(lanes)[0], data[i])),
+     ...);
+  }
+
+  return std::tuple<decltype(Rs::init)...>{[&] {
+    const auto& lane = std::get<Is>(lanes);
+    auto result = lane[0];
+    for (std::size_t k = 1; k < Lanes; ++k) {
+      result = std::get<Is>(rs).combine(result, lane[k]);
+    }
+    return result;
+  }()...};
+}
+
+template <class... Rs, std::size_t... Is>
+constexpr std::tuple<decltype(Rs::init)...> initial_accumulators(
+    const std::tuple<Rs...>& rs,
+    [[maybe_unused]] std::index_sequence<Is...> marker) {
+  return {std::get<Is>(rs).init...};
+}
+
+struct multi_fold_t {
+  template <class T, class... Rs>
+  constexpr auto operator()(T&& foldable, Rs&&... rs) const {
+    static_assert(sizeof...(Rs) > 0, "multi_fold needs a reduction");
+    using value_t = std::remove_reference_t<T>;
+    // Whatever the reductions, as with dpsg::fold
+    static_assert(!is_text_v<value_t>,
+                  "dpsg::multi_fold doesn't fold strings character by "
+                  "character");
+    using reductions_t = std::tuple<std::decay_t<Rs>...>;
+    const reductions_t reductions{std::forward<Rs>(rs)...};
+    const multi_step<std::decay_t<Rs>...> step{&reductions};
+    constexpr bool splittable =
+        (is_split_reduction<std::decay_t<Rs>>::value && ...);
+
+    if constexpr (splittable && is_contiguous_range<value_t>::value &&
+                  !is_text_v<value_t>) {
+      return fold_lanes<DPSG_MULTI_FOLD_LANES>(
+          std::data(foldable),
+          static_cast<std::size_t>(std::size(foldable)),
+          reductions,
+          std::index_sequence_for<Rs...>{});
+    }
+    else if constexpr (is_composite_v<value_t>) {
+      auto acc =
+          initial_accumulators(reductions, std::index_sequence_for<Rs...>{});
+      dpsg::traverse(foldable, [&acc, &step](const auto& node, auto&& next) {
+        acc = step(std::move(acc), node);
+        next();
+      });
+      return acc;
+    }
+    else {
+      return dpsg::fold(
+          std::forward<T>(foldable),
+          initial_accumulators(reductions, std::index_sequence_for<Rs...>{}),
+          step);
+    }
+  }
+};
+
+}  // namespace detail
+
+constexpr static inline detail::multi_fold_t multi_fold{};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_MULTI_FOLD_HPP
@@ -0,0 +1,235 @@
+#ifndef GUARD_DPSG_ONLY_HPP
+#define GUARD_DPSG_ONLY_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "./composite.hpp"
+#include "./fold.hpp"
+#include "./is_range.hpp"
+#include "./traverse.hpp"
+
+/* template<class... Ts> traverse_only;
+   template<class... Ts> fold_only;
+
+    Typed traversal: visit only the elements whose type is one of Ts, however
+   deep they are in the structure, and skip everything else.
+
+    Which subtrees may contain one of Ts is computed at compile time from the
+   static shape of the types (tuples, pairs, variants, optionals, arrays,
+   ranges and composites). Subtrees that can't contain any of them are never
+   walked, so that a targeted query over a large static hierarchy costs only
+   what it touches. Traversable types of unknown shape (user-defined
+   dpsg_traverse) are conservatively walked. Strings and string views are
+   leaves, as with dpsg::traverse: they can be selected, but their characters
+   are never visited.
+
+        constexpr doc::document document = ...;
+        int titles = 0;
+        dpsg::traverse_only<doc::title>(document, [&](const doc::title& t) {
+          ++titles;
+        });
+        auto length = dpsg::fold_only<doc::p>(document, 0, [](int acc,
+                                                              const doc::p& p) {
+          return acc + std::strlen(p.text);
+        });
+
+    Matching elements are given to the visitor as they are (with the extra
+   arguments if any), and are not searched any further. Composite components
+   are reached directly, the visitor doesn't receive any `next` function.
+
+    may_contain_v<U, Ts...> exposes the underlying predicate.
+*/
+
+namespace dpsg {
+
+namespace detail {
+
+template <class... Ts>
+struct type_list {};
+
+template <class U, class List>
+struct in_list;
+template <class U, class... Ts>
+struct in_list<U, type_list<Ts...>>
+    : std::bool_constant<(std::is_same_v<U, Ts> || ...)> {};
+
+template <class List, class U>
+struct append;
+template <class... Ts, class U>
+struct append<type_list<Ts...>, U> {
+  using type = type_list<Ts..., U>;
+};
+
+// Types of the elements of a structure whose shape is known
+template <class T>
+struct element_types {};
+template <class... Ts>
+struct element_types<std::tuple<Ts...>> {
+  using type = type_list<Ts...>;
+};
+template <class... Ts>
+struct element_types<compressed_tuple<Ts...>> {
+  using type = type_list<Ts...>;
+};
+template <class A, class B>
+struct element_types<std::pair<A, B>> {
+  using type = type_list<A, B>;
+};
+template <class... Ts>
+struct element_types<std::variant<Ts...>> {
+  using type = type_list<Ts...>;
+};
+template <class T>
+struct element_types<std::optional<T>> {
+  using type = type_list<T>;
+};
+template <class T, std::size_t N>
+struct element_types<std::array<T, N>> {
+  using type = type_list<T>;
+};
+template <class T, std::size_t N>
+struct element_types<T[N]> {
+  using type = type_list<T>;
+};
+
+template <class T, class = void>
+struct has_element_types : std::false_type {};
+template <class T>
+struct has_element_types<T, std::void_t<typename element_types<T>::type>>
+    : std::true_type {};
+
+template <class T>
+using bare_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+template <class U, class Visited, class... Ts>
+constexpr bool may_contain();
+
+template <class Visited, class... Ts, class... Es>
+constexpr bool any_may_contain([[maybe_unused]] type_list<Es...> elements) {
+  return (may_contain<Es, Visited, Ts...>() || ...);
+}
+
+template <class U, class Visited, class... Ts>
+constexpr bool may_contain() {
+  using V = bare_t<U>;
+  if constexpr ((std::is_same_v<V, Ts> || ...)) {
+    return true;
+  }
+  else if constexpr (is_text_v<V>) {
+    // Text isn't traversed, its characters are out of reach
+    return false;
+  }
+  else if constexpr (in_list<V, Visited>::value) {
+    // Recursive types are explored only once
+    return false;
+  }
+  else {
+    using now_visited = typename append<Visited, V>::type;
+    if constexpr (is_composite_v<V>) {
+      return may_contain<decltype(std::declval<V&>().components),
+                         now_visited,
+                         Ts...>();
+    }
+    else if constexpr (has_element_types<V>::value) {
+      return any_may_contain<now_visited, Ts...>(
+          typename element_types<V>::type{});
+    }
+    else if constexpr (is_range_v<V>) {
+      return may_contain<decltype(*adl_begin(std::declval<V&>())),
+                         now_visited,
+                         Ts...>();
+    }
+    else {
+      // Unknown shape, it can't be pruned
+      return is_traversable_v<V&>;
+    }
+  }
+}
+
+}  // namespace detail
+
+template <class U, class... Ts>
+constexpr static inline bool may_contain_v =
+    detail::may_contain<U, detail::type_list<>, Ts...>();
+
+namespace detail {
+
+template <class... Ts>
+struct traverse_only_t {
+  template <class U, class F, class... Args>
+  constexpr void operator()(U&& u, F&& f, Args&&... args) const {
+    visit(std::forward<U>(u), f, args...);
+  }
+
+ private:
+  template <class U, class F, class... Args>
+  constexpr static void visit(U&& u, F& f, Args&... args) {
+    using V = bare_t<U>;
+    if constexpr ((std::is_same_v<V, Ts> || ...)) {
+      f(std::forward<U>(u), args...);
+    }
+    else if constexpr (!may_contain_v<V, Ts...>) {
+      // Nothing to see here
+    }
+    else if constexpr (is_composite_v<V>) {
+      visit(u.components, f, args...);
+    }
+    else {
+      dpsg::traverse(std::forward<U>(u), [&f, &args...](auto&& element) {
+        visit(std::forward<decltype(element)>(element), f, args...);
+      });
+    }
+  }
+};
+
+template <class... Ts>
+struct fold_only_t {
+  template <class U, class A, class F, class... Args>
+  constexpr auto operator()(U&& u, A&& acc, F&& fun, Args&&... extra) const {
+    return visit(std::forward<U>(u), std::forward<A>(acc), fun, extra...);
+  }
+
+ private:
+  template <class U, class A, class F, class... Args>
+  constexpr static auto visit(U&& u, A&& acc, F& fun, Args&... extra) {
+    using V = bare_t<U>;
+    if constexpr ((std::is_same_v<V, Ts> || ...)) {
+      return fun(std::forward<A>(acc), std::forward<U>(u), extra...);
+    }
+    else if constexpr (!may_contain_v<V, Ts...>) {
+      return std::forward<A>(acc);
+    }
+    else if constexpr (is_composite_v<V>) {
+      return visit(u.components, std::forward<A>(acc), fun, extra...);
+    }
+    else {
+      return dpsg::fold(
+          std::forward<U>(u),
+          std::forward<A>(acc),
+          [&fun, &extra...](auto&& a, auto&& element) {
+            return visit(std::forward<decltype(element)>(element),
+                         std::forward<decltype(a)>(a),
+                         fun,
+                         extra...);
+          });
+    }
+  }
+};
+
+}  // namespace detail
+
+template <class... Ts>
+constexpr static inline detail::traverse_only_t<Ts...> traverse_only{};
+
+template <class... Ts>
+constexpr static inline detail::fold_only_t<Ts...> fold_only{};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_ONLY_HPP
@@ -0,0 +1,182 @@
+#ifndef GUARD_DPSG_PREFETCH_HPP
+#define GUARD_DPSG_PREFETCH_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "./is_range.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+/* template<class T, class P> auto prefetched(T&& range,
+                                              std::size_t distance,
+                                              P projection);
+
+    Opt-in traversal mode for node-based ranges (std::map, std::set,
+   std::list, intrusive lists...). Walking such a range is bound by memory
+   latency since every node is a dependent load. The view returned by
+   prefetched() walks a second iterator `distance` elements ahead of the
+   visited one and issues a software prefetch for it, so that the cache misses
+   of the upcoming nodes overlap with the work done by the visitor.
+
+    Prefetching can't shorten the chain of dependent loads itself: a visitor
+   doing next to nothing won't run any faster. The gain comes with visitors
+   doing actual work per element (see benchmarks/prefetch.cpp).
+
+    By default the address of the element itself is prefetched. A projection
+   returning a pointer (or a range of pointers) may be given to prefetch data
+   that the visitor is going to touch as well, typically the payload an
+   element points to.
+
+        std::map<int, std::unique_ptr<payload>> map = ...;
+
+        dpsg::traverse(dpsg::prefetched(map), f);
+        dpsg::traverse(dpsg::prefetched(map, 16), f);
+        dpsg::fold(dpsg::prefetched(map,
+                                    16,
+                                    [](const auto& kv) {
+                                      return kv.second.get();
+                                    }),
+                   0,
+                   sum);
+
+    As with any other range, elements are given to the visitor as lvalues.
+   The view holds a reference to the range and is meant to be consumed in the
+   full expression that created it.
+*/
+
+namespace dpsg {
+
+constexpr static inline std::size_t default_prefetch_distance = 8;
+
+inline void prefetch([[maybe_unused]] const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#endif
+}
+
+namespace detail {
+
+struct element_address {
+  template <class T>
+  constexpr const void* operator()(const T& element) const noexcept {
+    return std::addressof(element);
+  }
+};
+
+template <class P>
+void prefetch_projection(P&& projected) noexcept {
+  if constexpr (std::is_pointer_v<std::decay_t<P>>) {
+    prefetch(projected);
+  }
+  else if constexpr (is_range_v<P>) {
+    for (auto&& address : projected) {
+      prefetch(address);
+    }
+  }
+  else {
+    prefetch(std::addressof(*projected));
+  }
+}
+
+template <class T, class P>
+class prefetching_walk {
+  using iterator = decltype(adl_begin(std::declval<T&>()));
+  using sentinel = decltype(adl_end(std::declval<T&>()));
+
+ public:
+  prefetching_walk(T& range, std::size_t distance, P& projection)
+      : current_{adl_begin(range)},
+        ahead_{current_},
+        last_{adl_end(range)},
+        projection_{projection} {
+    for (std::size_t i = 0; i < distance && ahead_ != last_; ++i) {
+      advance_ahead();
+    }
+  }
+
+  [[nodiscard]] bool done() const { return current_ == last_; }
+
+  decltype(auto) current() const { return *current_; }
+
+  void next() {
+    if (ahead_ != last_) {
+      advance_ahead();
+    }
+    ++current_;
+  }
+
+ private:
+  void advance_ahead() {
+    prefetch_projection(projection_(*ahead_));
+    ++ahead_;
+  }
+
+  iterator current_;
+  iterator ahead_;
+  sentinel last_;
+  P& projection_;
+};
+
+}  // namespace detail
+
+template <class T, class P = detail::element_address>
+struct prefetch_view {
+  T&& range;
+  std::size_t distance;
+  P projection;
+
+  template <class F, class... Args>
+  friend void dpsg_traverse(const prefetch_view& view,
+                            F&& f,
+                            Args&&... args) {
+    P projection = view.projection;
+    for (detail::prefetching_walk<std::remove_reference_t<T>, P> walk{
+             view.range, view.distance, projection};
+         !walk.done();
+         walk.next()) {
+      f(walk.current(), args...);
+    }
+  }
+
+  template <class A, class F, class... Args>
+  friend std::decay_t<A> dpsg_fold(const prefetch_view& view,
+                                   A&& acc,
+                                   F&& fun,
+                                   Args&&... extra) {
+    std::decay_t<A> result = std::forward<A>(acc);
+    P projection = view.projection;
+    for (detail::prefetching_walk<std::remove_reference_t<T>, P> walk{
+             view.range, view.distance, projection};
+         !walk.done();
+         walk.next()) {
+      result = fun(std::move(result), walk.current(), extra...);
+    }
+    return result;
+  }
+};
+
+#if defined(__cpp_concepts)
+template <iterable T, class P = detail::element_address>
+#else
+template <class T,
+          class P = detail::element_address,
+          std::enable_if_t<is_range_v<T>, int> = 0>
+#endif
+prefetch_view<T, std::decay_t<P>> prefetched(
+    T&& range,
+    std::size_t distance = default_prefetch_distance,
+    P&& projection = {}) {
+  return {std::forward<T>(range), distance, std::forward<P>(projection)};
+}
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_PREFETCH_HPP
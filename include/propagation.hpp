@@ -0,0 +1,214 @@
+#ifndef GUARD_DPSG_PROPAGATION_HPP
+#define GUARD_DPSG_PROPAGATION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "./composite.hpp"
+#include "./traverse.hpp"
+#include "./walk.hpp"
+
+/* template<class Local, class Derived, class Combine>
+   class propagation_cache;
+
+    Hierarchical state propagation, for scene graphs and the like: every node
+   has a local state (a transform relative to its parent, say) and a derived
+   state computed from the derived state of its parent and its own local
+   state (its world transform):
+
+        derived(node) = combine(derived(parent), local(node))
+        derived(root) = combine(root_state, local(root))
+
+    Passing the parent state to the children through next(args...) computes
+   this, but for the whole hierarchy on every traversal, and with the state
+   scattered on the call stack. A propagation_cache instead stores the parent
+   index, the local state and the derived state of every node in separate
+   arrays (structure of arrays), in pre-order. Changing the local state of a
+   node marks it dirty, and update() recomputes the derived state of the dirty
+   nodes and their descendants only, in a single forward sweep over each
+   subtree: a parent always comes before its children in the arrays.
+
+        struct matrix { ... };
+        matrix operator*(const matrix&, const matrix&);
+
+        dpsg::propagation_cache<matrix> transforms{identity};
+        transforms.assign(scene, [](const auto& node) { return node.local; });
+        transforms.update();
+        draw(mesh, transforms.derived(i));
+
+        transforms.set_local(i, rotate(transforms.local(i), angle));
+        transforms.update();  // recomputes the subtree of node i only
+
+    assign() builds the cache from a dpsg::composite, whose components are
+   reached through the usual next(args...) protocol, or from any tree that
+   dpsg::walk understands. The function given to it is called on every node
+   to get its local state. Nodes are numbered in pre-order, in the order in
+   which they are visited by dpsg::traverse or by dpsg::walk(dpsg::pre_order,
+   ...). Nodes can also be added one by one with push(parent, local), as long
+   as they are added in pre-order.
+
+    Combine defaults to std::multiplies<>, which is what transforms need.
+*/
+
+namespace dpsg {
+
+template <class Local,
+          class Derived = Local,
+          class Combine = std::multiplies<>>
+class propagation_cache {
+ public:
+  using index = std::size_t;
+  constexpr static inline index no_parent = std::numeric_limits<index>::max();
+
+  explicit propagation_cache(Derived root_state = Derived{},
+                             Combine combine = Combine{})
+      : root_state_{std::move(root_state)}, combine_{std::move(combine)} {}
+
+  // Replaces the content of the cache with the nodes of a hierarchy
+  template <class Root, class LocalOf>
+  void assign(const Root& root, LocalOf&& local_of) {
+    clear();
+    auto visitor = [this, &local_of](const auto& node, auto next, index up) {
+      next(push(up, local_of(node)));
+    };
+    if constexpr (is_composite_v<Root>) {
+      dpsg::traverse(root, visitor, no_parent);
+    }
+    else {
+      dpsg::walk(pre_order, root, visitor, no_parent);
+    }
+  }
+
+  // Adds a node, whose parent must have been added before it. Nodes must be
+  // added in pre-order
+  index push(index parent, Local local) {
+    const index i = parent_.size();
+    parent_.push_back(parent);
+    local_.push_back(std::move(local));
+    derived_.emplace_back();
+    subtree_end_.push_back(i + 1);
+    dirty_.push_back(false);
+    structure_changed_ = true;
+    return i;
+  }
+
+  void reserve(std::size_t size) {
+    parent_.reserve(size);
+    local_.reserve(size);
+    derived_.reserve(size);
+    subtree_end_.reserve(size);
+    dirty_.reserve(size);
+  }
+
+  void clear() noexcept {
+    parent_.clear();
+    local_.clear();
+    derived_.clear();
+    subtree_end_.clear();
+    dirty_.clear();
+    pending_.clear();
+    structure_changed_ = true;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return parent_.size(); }
+  [[nodiscard]] index parent(index i) const noexcept { return parent_[i]; }
+  [[nodiscard]] const Local& local(index i) const noexcept { return local_[i]; }
+
+  // Up to date after the last call to update()
+  [[nodiscard]] const Derived& derived(index i) const noexcept {
+    return derived_[i];
+  }
+  [[nodiscard]] const Derived* derived_data() const noexcept {
+    return derived_.data();
+  }
+
+  void set_local(index i, Local local) {
+    local_[i] = std::move(local);
+    mark_dirty(i);
+  }
+
+  void mark_dirty(index i) {
+    if (!dirty_[i]) {
+      dirty_[i] = true;
+      pending_.push_back(i);
+    }
+  }
+
+  // Changes the state given to the roots, every node is recomputed
+  void set_root_state(Derived root_state) {
+    root_state_ = std::move(root_state);
+    structure_changed_ = true;
+  }
+
+  // Recomputes the derived state of the dirty nodes and of their
+  // descendants. Returns the number of nodes recomputed
+  std::size_t update() {
+    if (structure_changed_) {
+      compute_subtree_ends();
+      recompute(0, size());
+      for (index i : pending_) {
+        dirty_[i] = false;
+      }
+      pending_.clear();
+      structure_changed_ = false;
+      return size();
+    }
+
+    // Dirty nodes are handled in order, so that a dirty node nested in the
+    // subtree of another one is covered by the sweep of its ancestor
+    std::sort(pending_.begin(), pending_.end());
+    std::size_t count = 0;
+    index done = 0;
+    for (index i : pending_) {
+      dirty_[i] = false;
+      if (i < done) {
+        continue;
+      }
+      done = subtree_end_[i];
+      recompute(i, done);
+      count += done - i;
+    }
+    pending_.clear();
+    return count;
+  }
+
+ private:
+  void compute_subtree_ends() {
+    for (index i = 0; i < size(); ++i) {
+      subtree_end_[i] = i + 1;
+    }
+    for (index i = size(); i-- > 0;) {
+      const index p = parent_[i];
+      if (p != no_parent && subtree_end_[p] < subtree_end_[i]) {
+        subtree_end_[p] = subtree_end_[i];
+      }
+    }
+  }
+
+  void recompute(index first, index last) {
+    for (index i = first; i < last; ++i) {
+      const index p = parent_[i];
+      derived_[i] = combine_(p == no_parent ? root_state_ : derived_[p],
+                             local_[i]);
+    }
+  }
+
+  std::vector<index> parent_;
+  std::vector<Local> local_;
+  std::vector<Derived> derived_;
+  // One past the last descendant of each node
+  std::vector<index> subtree_end_;
+  std::vector<bool> dirty_;
+  std::vector<index> pending_;
+  bool structure_changed_{true};
+  Derived root_state_;
+  Combine combine_;
+};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_PROPAGATION_HPP
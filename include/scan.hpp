@@ -0,0 +1,375 @@
+#ifndef GUARD_DPSG_SCAN_HPP
+#define GUARD_DPSG_SCAN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./fold.hpp"
+#include "./is_range.hpp"
+#include "./is_template_instance.hpp"
+#include "./unroll.hpp"
+
+/* constexpr auto fold_right(T&& t, A&& acc, F&& fun, Args&&... extra);
+   constexpr auto inclusive_scan(T&& t, A&& init, F&& fun, Args&&... extra);
+   constexpr auto exclusive_scan(T&& t, A&& init, F&& fun, Args&&... extra);
+   Out parallel_inclusive_scan(R&& range, Out out, A&& init, F&& fun);
+   Out parallel_exclusive_scan(R&& range, Out out, A&& init, F&& fun);
+
+    fold_right works like dpsg::fold, fun(acc, element, extra...) and all,
+   but goes from the last element to the first. It supports tuples
+   (std::tuple and dpsg::compressed_tuple), pairs, fixed size arrays and
+   bidirectional ranges, and optionals and variants, for which it is the
+   same as dpsg::fold.
+
+    The scans return every intermediate accumulator of a fold instead of only
+   the last one. inclusive_scan gives the accumulator after each element,
+   exclusive_scan the accumulator before each element (so starting with
+   init, and without the final result):
+
+        constexpr auto sums = dpsg::inclusive_scan(
+            std::tuple{1, 2.5, 3}, 0, std::plus<>{});
+        static_assert(sums == std::tuple{1, 3.5, 6.5});
+
+        std::vector<std::size_t> sizes = {3, 1, 4};
+        auto offsets = dpsg::exclusive_scan(sizes, 0, std::plus<>{});
+        // {0, 3, 4}
+
+    Tuples and pairs give a std::tuple whose element types are the types
+   returned by fun along the way, and are computed at compile time when
+   possible. Fixed size arrays give a std::array and other ranges a
+   std::vector, the type of the accumulator being fixed by init.
+
+    The parallel scans write the result for the range (which must be random
+   access) to the random access iterator out, and return the end of the
+   output. Large inputs are split into contiguous chunks, one per thread,
+   and scanned in two passes: the total of every chunk is computed in
+   parallel, the totals are combined sequentially to give the offset of
+   every chunk, then every chunk is scanned in parallel from its offset.
+   This requires fun to be associative and to combine two accumulators as
+   well as an accumulator and an element, and elements to be convertible to
+   the accumulator type. The number of threads can be capped with a fifth
+   argument; inputs of less than parallel_scan_min_chunk elements per thread
+   are scanned sequentially. Exceptions thrown by fun are rethrown in the
+   calling thread, as is the std::system_error of a thread that fails to
+   start (after joining the threads already started).
+*/
+
+namespace dpsg {
+
+// Below this number of elements per thread, the parallel scans don't bother
+// starting threads
+constexpr static inline std::size_t parallel_scan_min_chunk = 1 << 15;
+
+namespace detail {
+
+// Tuples as unroll.hpp knows them, and pairs
+template <class T>
+constexpr static inline bool is_tuple_like_v =
+    is_tuple_v<T> ||
+    is_template_instance_v<std::remove_cv_t<std::remove_reference_t<T>>,
+                           std::pair>;
+
+template <class T>
+constexpr static inline std::size_t tuple_size_v =
+    std::tuple_size_v<std::remove_cv_t<std::remove_reference_t<T>>>;
+
+template <std::size_t I, class T, class A, class F, class... Args>
+constexpr auto fold_right_tuple([[maybe_unused]] T&& tuple,
+                                A&& acc,
+                                [[maybe_unused]] F& fun,
+                                [[maybe_unused]] Args&... extra) {
+  if constexpr (I == 0) {
+    return std::forward<A>(acc);
+  }
+  else {
+    return fold_right_tuple<I - 1>(
+        std::forward<T>(tuple),
+        fun(std::forward<A>(acc),
+            tuple_get<I - 1>(std::forward<T>(tuple)),
+            extra...),
+        fun,
+        extra...);
+  }
+}
+
+// Scans the first N elements of a tuple, from the I-th
+template <std::size_t I,
+          std::size_t N,
+          class T,
+          class A,
+          class F,
+          class... Args>
+constexpr auto scan_tuple([[maybe_unused]] T&& tuple,
+                          [[maybe_unused]] const A& acc,
+                          [[maybe_unused]] F& fun,
+                          [[maybe_unused]] Args&... extra) {
+  if constexpr (I == N) {
+    return std::tuple<>{};
+  }
+  else {
+    using result_t = std::decay_t<decltype(fun(
+        acc, tuple_get<I>(std::forward<T>(tuple)), extra...))>;
+    std::tuple<result_t> current{
+        fun(acc, tuple_get<I>(std::forward<T>(tuple)), extra...)};
+    return std::tuple_cat(
+        current,
+        scan_tuple<I + 1, N>(
+            std::forward<T>(tuple), std::get<0>(current), fun, extra...));
+  }
+}
+
+template <bool Inclusive, class T, class A, class F, class... Args>
+constexpr auto scan_array(T&& array, A&& init, F& fun, Args&... extra) {
+  constexpr std::size_t size = fixed_size_array_v<T>;
+  std::array<std::decay_t<A>, size> result{};
+  std::decay_t<A> acc = std::forward<A>(init);
+  for (std::size_t i = 0; i < size; ++i) {
+    if constexpr (Inclusive) {
+      acc = fun(std::move(acc), forward_element<T>(array[i]), extra...);
+      result[i] = acc;
+    }
+    else {
+      result[i] = acc;
+      acc = fun(std::move(acc), forward_element<T>(array[i]), extra...);
+    }
+  }
+  return result;
+}
+
+template <class T, class = void>
+struct is_sized : std::false_type {};
+template <class T>
+struct is_sized<T, std::void_t<decltype(std::size(std::declval<T&>()))>>
+    : std::true_type {};
+
+template <bool Inclusive, class T, class A, class F, class... Args>
+std::vector<std::decay_t<A>> scan_range(T& range,
+                                        A&& init,
+                                        F& fun,
+                                        Args&... extra) {
+  std::vector<std::decay_t<A>> result;
+  if constexpr (is_sized<T>::value) {
+    result.reserve(std::size(range));
+  }
+  std::decay_t<A> acc = std::forward<A>(init);
+  for (auto&& element : range) {
+    if constexpr (Inclusive) {
+      acc = fun(std::move(acc), element, extra...);
+      result.push_back(acc);
+    }
+    else {
+      result.push_back(acc);
+      acc = fun(std::move(acc), element, extra...);
+    }
+  }
+  return result;
+}
+
+template <bool Inclusive>
+struct scan_t {
+  template <class T, class A, class F, class... Args>
+  constexpr auto operator()(T&& t, A&& init, F&& fun, Args&&... extra) const {
+    if constexpr (is_tuple_like_v<T>) {
+      constexpr std::size_t size = tuple_size_v<T>;
+      if constexpr (Inclusive) {
+        return scan_tuple<0, size>(std::forward<T>(t), init, fun, extra...);
+      }
+      else if constexpr (size == 0) {
+        return std::tuple<>{};
+      }
+      else {
+        auto rest =
+            scan_tuple<0, size - 1>(std::forward<T>(t), init, fun, extra...);
+        return std::tuple_cat(
+            std::tuple<std::decay_t<A>>{std::forward<A>(init)},
+            std::move(rest));
+      }
+    }
+    else if constexpr (is_fixed_size_array_v<T>) {
+      return scan_array<Inclusive>(
+          std::forward<T>(t), std::forward<A>(init), fun, extra...);
+    }
+    else {
+      static_assert(is_range_v<T>,
+                    "dpsg scans support tuples, pairs, arrays and ranges");
+      return scan_range<Inclusive>(t, std::forward<A>(init), fun, extra...);
+    }
+  }
+};
+
+struct fold_right_t {
+  template <class T, class A, class F, class... Args>
+  constexpr auto operator()(T&& t, A&& acc, F&& fun, Args&&... extra) const {
+    using V = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (is_tuple_like_v<T>) {
+      return fold_right_tuple<tuple_size_v<T>>(
+          std::forward<T>(t), std::forward<A>(acc), fun, extra...);
+    }
+    else if constexpr (is_template_instance_v<V, std::optional> ||
+                       is_template_instance_v<V, std::variant>) {
+      return dpsg::fold(
+          std::forward<T>(t), std::forward<A>(acc), fun, extra...);
+    }
+    else if constexpr (is_fixed_size_array_v<T>) {
+      constexpr std::size_t size = fixed_size_array_v<T>;
+      std::decay_t<A> result = std::forward<A>(acc);
+      for (std::size_t i = size; i-- > 0;) {
+        result = fun(std::move(result), forward_element<T>(t[i]), extra...);
+      }
+      return result;
+    }
+    else {
+      static_assert(is_range_v<T>,
+                    "dpsg::fold_right supports tuples, pairs, arrays, "
+                    "optionals, variants and bidirectional ranges");
+      std::decay_t<A> result = std::forward<A>(acc);
+      const auto first = adl_begin(t);
+      auto last = adl_end(t);
+      while (last != first) {
+        --last;
+        result = fun(std::move(result), *last, extra...);
+      }
+      return result;
+    }
+  }
+};
+
+template <bool Inclusive>
+struct parallel_scan_t {
+  template <class R, class Out, class A, class F>
+  Out operator()(R&& range,
+                 Out out,
+                 A&& init,
+                 F&& fun,
+                 std::size_t max_threads = 0) const {
+    using acc_t = std::decay_t<A>;
+    const auto first = adl_begin(range);
+    const std::size_t size =
+        static_cast<std::size_t>(std::distance(first, adl_end(range)));
+
+    if (max_threads == 0) {
+      max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    const std::size_t threads =
+        std::min(max_threads, size / parallel_scan_min_chunk);
+    if (threads <= 1) {
+      scan_chunk(first, out, size, acc_t(std::forward<A>(init)), fun);
+      return out + size;
+    }
+
+    const std::size_t chunk = (size + threads - 1) / threads;
+    const auto chunk_size = [size, chunk](std::size_t i) {
+      return std::min(chunk, size - i * chunk);
+    };
+    std::vector<acc_t> offsets(threads, acc_t(init));
+    std::vector<std::exception_ptr> errors(threads);
+
+    // First pass: the totals of all the chunks but the last, stored one
+    // place to the right
+    run(threads, errors, [&](std::size_t i) {
+      if (i + 1 == threads) {
+        return;
+      }
+      auto it = first + i * chunk;
+      acc_t total(*it);
+      for (std::size_t j = 1; j < chunk_size(i); ++j) {
+        total = fun(std::move(total), *++it);
+      }
+      offsets[i + 1] = std::move(total);
+    });
+
+    offsets[0] = std::forward<A>(init);
+    for (std::size_t i = 1; i < threads; ++i) {
+      offsets[i] = fun(offsets[i - 1], std::move(offsets[i]));
+    }
+
+    // Second pass: every chunk is scanned from its offset
+    run(threads, errors, [&](std::size_t i) {
+      scan_chunk(first + i * chunk,
+                 out + i * chunk,
+                 chunk_size(i),
+                 std::move(offsets[i]),
+                 fun);
+    });
+    return out + size;
+  }
+
+ private:
+  template <class It, class Out, class Acc, class F>
+  static void scan_chunk(It first, Out out, std::size_t size, Acc acc, F& f) {
+    for (std::size_t i = 0; i < size; ++i, ++first, ++out) {
+      if constexpr (Inclusive) {
+        acc = f(std::move(acc), *first);
+        *out = acc;
+      }
+      else {
+        *out = acc;
+        acc = f(std::move(acc), *first);
+      }
+    }
+  }
+
+  // Runs task(i) for every i in [0, threads), the calling thread taking
+  // i == 0
+  template <class Task>
+  static void run(std::size_t threads,
+                  std::vector<std::exception_ptr>& errors,
+                  Task&& task) {
+    const auto guarded = [&task, &errors](std::size_t i) {
+      try {
+        task(i);
+      }
+      catch (...) {
+        errors[i] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    const auto join_all = [&workers] {
+      for (auto& worker : workers) {
+        worker.join();
+      }
+    };
+    try {
+      for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(guarded, i);
+      }
+    }
+    catch (...) {
+      // Threads that did start must not be destroyed while joinable
+      join_all();
+      throw;
+    }
+    guarded(0);
+    join_all();
+    for (auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+};
+
+}  // namespace detail
+
+constexpr static inline detail::fold_right_t fold_right{};
+constexpr static inline detail::scan_t<true> inclusive_scan{};
+constexpr static inline detail::scan_t<false> exclusive_scan{};
+constexpr static inline detail::parallel_scan_t<true>
+    parallel_inclusive_scan{};
+constexpr static inline detail::parallel_scan_t<false>
+    parallel_exclusive_scan{};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_SCAN_HPP
@@ -8,7 +8,9 @@
 #include <variant>
 
 #include "./feed.hpp"
+#include "./is_range.hpp"
 #include "./is_template_instance.hpp"
+#include "./unroll.hpp"
 
 namespace dpsg {
 
@@ -47,10 +49,18 @@ constexpr void dpsg_traverse(T&& tuple, F&& f, Args&&... args) noexcept(
                                    std::forward<F>(f),
                                    feed_t<T, std::index_sequence_for>{},
                                    std::forward<Args>(args)...))) {
-  detail::apply_to_each(std::forward<T>(tuple),
-                        std::forward<F>(f),
-                        feed_t<T, std::index_sequence_for>{},
-                        std::forward<Args>(args)...);
+  if constexpr (std::tuple_size_v<std::decay_t<T>> <=
+                default_tuple_unroll_limit_t::value) {
+    detail::apply_to_each(std::forward<T>(tuple),
+                          std::forward<F>(f),
+                          feed_t<T, std::index_sequence_for>{},
+                          std::forward<Args>(args)...);
+  }
+  else {
+    // Large tuples go through indexed dispatch, see unroll.hpp
+    dpsg::detail::traverse_tuple<default_tuple_unroll_limit_t>(
+        std::forward<T>(tuple), f, args...);
+  }
 }
 
 #if defined(__cpp_concepts)
@@ -64,9 +74,12 @@ template <class T,
               int> = 0>
 #endif
 constexpr inline void dpsg_traverse(T&& variant, F&& f, Args&&... args) {
-  std::visit(std::forward<F>(f),
-             std::forward<T>(variant),
-             std::forward<Args>(args)...);
+  // Extra arguments aren't variants, they can't go through std::visit
+  std::visit(
+      [&f, &args...](auto&& alternative) {
+        f(std::forward<decltype(alternative)>(alternative), args...);
+      },
+      std::forward<T>(variant));
 }
 
 #if defined(__cpp_concepts)
@@ -101,6 +114,24 @@ constexpr void dpsg_traverse(T&& pair, F&& f, Args&&... args) {
     std::forward<F>(f)(*std::forward<T>(pair), std::forward<Args>(args)...);
   }
 }
+
+// String literals are text, see is_range.hpp
+#if defined(__cpp_concepts)
+template <fixed_size_array T, class F, class... Args>
+requires(!dpsg::detail::is_text_v<T>)
+#else
+template <class T,
+          class F,
+          class... Args,
+          std::enable_if_t<dpsg::is_fixed_size_array_v<T> &&
+                               !dpsg::detail::is_text_v<T>,
+                           int> = 0>
+#endif
+constexpr void dpsg_traverse(T&& array, F&& f, Args&&... args) {
+  dpsg::detail::traverse_array<default_unroll_limit_t>(
+      std::forward<T>(array), f, args...);
+}
+
 }  // namespace customization_points
 
 namespace detail {
@@ -111,14 +142,25 @@ struct {
 } constexpr static inline ignore;
 
 template <class T, class = void>
-struct is_traversable : std::false_type {};
+struct has_dpsg_traverse : std::false_type {};
 
 template <class T>
-struct is_traversable<
+struct has_dpsg_traverse<
     T,
     std::void_t<decltype(dpsg_traverse(std::declval<T>(), ignore))>>
     : std::true_type {};
 
+// Other ranges are traversed with a loop. This is a fallback rather than an
+// overload of dpsg_traverse, so that it never competes with a customization
+template <class T>
+constexpr static inline bool is_loop_traversable_v =
+    is_range_v<T> && !is_text_v<T> && !has_dpsg_traverse<T>::value;
+
+template <class T>
+struct is_traversable
+    : std::bool_constant<has_dpsg_traverse<T>::value ||
+                         is_loop_traversable_v<T>> {};
+
 }  // namespace detail
 
 template <class T>
@@ -143,8 +185,15 @@ struct traverse_t {
             std::enable_if_t<is_traversable_v<T>, int> = 0>
 #endif
   constexpr void operator()(T&& t, F&& f, Args&&... args) const {
-    dpsg_traverse(
-        std::forward<T>(t), std::forward<F>(f), std::forward<Args>(args)...);
+    if constexpr (has_dpsg_traverse<T>::value) {
+      dpsg_traverse(
+          std::forward<T>(t), std::forward<F>(f), std::forward<Args>(args)...);
+    }
+    else {
+      for (auto&& element : t) {
+        f(element, args...);
+      }
+    }
   }
 };
 }  // namespace detail
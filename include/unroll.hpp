@@ -0,0 +1,428 @@
+#ifndef GUARD_DPSG_UNROLL_HPP
+#define GUARD_DPSG_UNROLL_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./is_template_instance.hpp"
+
+/* template<std::size_t Limit> struct unroll_limit_t;
+
+    Policy deciding how fixed-size collections (std::array, C arrays,
+   std::tuple and dpsg::compressed_tuple) are traversed and folded.
+   Collections of at most Limit elements are fully unrolled at compile time,
+   larger ones are visited with a runtime loop. This trades code size
+   against speed.
+
+    The default limit is DPSG_DEFAULT_UNROLL_LIMIT (16 unless defined before
+   including any header of the library) for arrays, and
+   DPSG_DEFAULT_TUPLE_UNROLL_LIMIT (128) for tuples. The policy can be
+   overridden for a single call by wrapping the traversed object with
+   dpsg::with_policy:
+
+        std::array<int, 64> big{};
+        int c_array[3] = {1, 2, 3};
+
+        // 64 > 16, uses a loop
+        dpsg::traverse(big, f);
+        // forces the loop to be unrolled
+        dpsg::traverse(dpsg::with_policy(dpsg::always_unroll, big), f);
+        // never unrolls, even for tiny arrays
+        dpsg::fold(dpsg::with_policy(dpsg::never_unroll, c_array), 0, plus);
+        // custom threshold
+        dpsg::traverse(dpsg::with_policy(dpsg::unroll_limit<128>, big), f);
+
+    Unrolling a tuple inlines one call to the visitor per element. The loop
+   used instead for large tuples (indexed dispatch) goes through a table of
+   handlers with one entry per element, but the handlers are only
+   instantiated once per distinct element type, so that the code emitted
+   doesn't grow with the number of elements. It costs an indirect call per
+   element. Tuples are folded with a loop only if the accumulator keeps the
+   same type all along, and always unrolled in constant expressions (when
+   std::is_constant_evaluated is available, otherwise tuples are unrolled by
+   default whatever their size).
+
+    is_fixed_size_array_v<T> detects std::array and C arrays (without decaying
+   its argument), and fixed_size_array_v<T> gives their element count.
+*/
+
+#ifndef DPSG_DEFAULT_UNROLL_LIMIT
+#define DPSG_DEFAULT_UNROLL_LIMIT 16
+#endif
+
+#ifndef DPSG_DEFAULT_TUPLE_UNROLL_LIMIT
+#if defined(__cpp_lib_is_constant_evaluated)
+#define DPSG_DEFAULT_TUPLE_UNROLL_LIMIT 128
+#else
+#define DPSG_DEFAULT_TUPLE_UNROLL_LIMIT static_cast<std::size_t>(-1)
+#endif
+#endif
+
+namespace dpsg {
+
+template <class... Ts>
+class compressed_tuple;
+
+template <std::size_t Limit>
+struct unroll_limit_t : std::integral_constant<std::size_t, Limit> {};
+
+template <std::size_t Limit>
+constexpr static inline unroll_limit_t<Limit> unroll_limit{};
+
+using default_unroll_limit_t = unroll_limit_t<DPSG_DEFAULT_UNROLL_LIMIT>;
+constexpr static inline default_unroll_limit_t default_unroll_limit{};
+using default_tuple_unroll_limit_t =
+    unroll_limit_t<DPSG_DEFAULT_TUPLE_UNROLL_LIMIT>;
+constexpr static inline auto always_unroll =
+    unroll_limit<static_cast<std::size_t>(-1)>;
+constexpr static inline auto never_unroll = unroll_limit<0>;
+
+template <class T>
+struct is_unroll_policy : std::false_type {};
+template <std::size_t Limit>
+struct is_unroll_policy<unroll_limit_t<Limit>> : std::true_type {};
+template <class T>
+constexpr static inline bool is_unroll_policy_v = is_unroll_policy<T>::value;
+
+template <class T>
+struct is_fixed_size_array : std::false_type {};
+template <class T, std::size_t N>
+struct is_fixed_size_array<std::array<T, N>> : std::true_type {};
+template <class T, std::size_t N>
+struct is_fixed_size_array<T[N]> : std::true_type {};
+
+template <class T>
+constexpr static inline bool is_fixed_size_array_v =
+    is_fixed_size_array<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+template <class T>
+struct fixed_size_array_size;
+template <class T, std::size_t N>
+struct fixed_size_array_size<std::array<T, N>>
+    : std::integral_constant<std::size_t, N> {};
+template <class T, std::size_t N>
+struct fixed_size_array_size<T[N]> : std::integral_constant<std::size_t, N> {
+};
+
+template <class T>
+constexpr static inline std::size_t fixed_size_array_v =
+    fixed_size_array_size<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+#if defined(__cpp_concepts)
+template <class T>
+concept fixed_size_array = is_fixed_size_array_v<T>;
+#endif
+
+namespace detail {
+
+// Gives an element of the array the value category of the array itself
+template <class T, class E>
+constexpr decltype(auto) forward_element(E& element) noexcept {
+  if constexpr (std::is_lvalue_reference_v<T>) {
+    return element;
+  }
+  else {
+    return std::move(element);
+  }
+}
+
+template <class T, class F, class... Args, std::size_t... Is>
+constexpr void traverse_array_unrolled(
+    [[maybe_unused]] T&& array,
+    [[maybe_unused]] F& f,
+    [[maybe_unused]] std::index_sequence<Is...> marker,
+    [[maybe_unused]] Args&... args) {
+  (f(forward_element<T>(array[Is]), args...), ...);
+}
+
+template <class Policy, class T, class F, class... Args>
+constexpr void traverse_array(T&& array, F& f, Args&... args) {
+  constexpr std::size_t size = fixed_size_array_v<T>;
+  if constexpr (size <= Policy::value) {
+    traverse_array_unrolled(std::forward<T>(array),
+                            f,
+                            std::make_index_sequence<size>{},
+                            args...);
+  }
+  else {
+    for (std::size_t i = 0; i < size; ++i) {
+      f(forward_element<T>(array[i]), args...);
+    }
+  }
+}
+
+template <std::size_t S, class T, class A, class F, class... Args>
+constexpr auto fold_array_unrolled([[maybe_unused]] T&& array,
+                                   A&& acc,
+                                   [[maybe_unused]] F& fun,
+                                   [[maybe_unused]] Args&... args) {
+  if constexpr (S < fixed_size_array_v<T>) {
+    return fold_array_unrolled<S + 1>(
+        std::forward<T>(array),
+        fun(std::forward<A>(acc), forward_element<T>(array[S]), args...),
+        fun,
+        args...);
+  }
+  else {
+    return std::forward<A>(acc);
+  }
+}
+
+template <class Policy, class T, class A, class F, class... Args>
+constexpr auto fold_array(T&& array, A&& acc, F& fun, Args&... args) {
+  constexpr std::size_t size = fixed_size_array_v<T>;
+  if constexpr (size <= Policy::value) {
+    return fold_array_unrolled<0>(
+        std::forward<T>(array), std::forward<A>(acc), fun, args...);
+  }
+  else {
+    // The first application fixes the type of the accumulator for the loop
+    std::decay_t<decltype(fun(
+        std::forward<A>(acc), forward_element<T>(array[0]), args...))>
+        result =
+            fun(std::forward<A>(acc), forward_element<T>(array[0]), args...);
+    for (std::size_t i = 1; i < size; ++i) {
+      result = fun(std::move(result), forward_element<T>(array[i]), args...);
+    }
+    return result;
+  }
+}
+
+// std::tuple and dpsg::compressed_tuple, whose elements are reached with an
+// unqualified get<I> (std::get or dpsg::get)
+template <class T>
+constexpr static inline bool is_tuple_v =
+    is_template_instance_v<std::remove_cv_t<std::remove_reference_t<T>>,
+                           std::tuple> ||
+    is_template_instance_v<std::remove_cv_t<std::remove_reference_t<T>>,
+                           compressed_tuple>;
+
+namespace adl {
+using std::get;
+
+template <std::size_t I, class T>
+constexpr decltype(auto) tuple_get(T&& tuple) noexcept {
+  return get<I>(std::forward<T>(tuple));
+}
+}  // namespace adl
+using adl::tuple_get;
+
+constexpr bool constant_evaluation() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+  return std::is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+template <class R>
+void* erase_element(R& element) noexcept {
+  return const_cast<void*>(static_cast<const void*>(std::addressof(element)));
+}
+
+// One handler per distinct reference type R, shared by every element of
+// that type
+template <class F, class... Args>
+struct indexed_visitor {
+  using handler_t = void (*)(void*, F&, Args&...);
+
+  template <class R>
+  static void visit(void* element, F& f, Args&... args) {
+    f(static_cast<R>(*static_cast<std::remove_reference_t<R>*>(element)),
+      args...);
+  }
+
+  template <class... Rs>
+  constexpr static inline handler_t table[] = {&visit<Rs>...};
+};
+
+template <class A, class F, class... Args>
+struct indexed_folder {
+  using handler_t = A (*)(A&&, void*, F&, Args&...);
+
+  template <class R>
+  static A fold(A&& acc, void* element, F& fun, Args&... args) {
+    return fun(
+        std::move(acc),
+        static_cast<R>(*static_cast<std::remove_reference_t<R>*>(element)),
+        args...);
+  }
+
+  template <class... Rs>
+  constexpr static inline handler_t table[] = {&fold<Rs>...};
+};
+
+template <class T, class F, class... Args, std::size_t... Is>
+void traverse_tuple_indexed(T&& tuple,
+                            F& f,
+                            [[maybe_unused]] std::index_sequence<Is...> marker,
+                            Args&... args) {
+  constexpr auto& handlers = indexed_visitor<F, Args...>::template table<
+      decltype(tuple_get<Is>(std::forward<T>(tuple)))...>;
+  void* const elements[] = {erase_element(tuple_get<Is>(tuple))...};
+  for (std::size_t i = 0; i < sizeof...(Is); ++i) {
+    handlers[i](elements[i], f, args...);
+  }
+}
+
+template <class T, class F, class... Args, std::size_t... Is>
+constexpr void traverse_tuple_unrolled(
+    [[maybe_unused]] T&& tuple,
+    [[maybe_unused]] F& f,
+    [[maybe_unused]] std::index_sequence<Is...> marker,
+    [[maybe_unused]] Args&... args) {
+  (f(tuple_get<Is>(std::forward<T>(tuple)), args...), ...);
+}
+
+template <class Policy, class T, class F, class... Args>
+constexpr void traverse_tuple(T&& tuple, F& f, Args&... args) {
+  constexpr std::size_t size =
+      std::tuple_size_v<std::remove_cv_t<std::remove_reference_t<T>>>;
+  constexpr auto indices = std::make_index_sequence<size>{};
+  if constexpr (size > Policy::value) {
+    if (!constant_evaluation()) {
+      traverse_tuple_indexed(std::forward<T>(tuple), f, indices, args...);
+      return;
+    }
+  }
+  traverse_tuple_unrolled(std::forward<T>(tuple), f, indices, args...);
+}
+
+template <class T, class A, class F, class... Args, std::size_t... Is>
+constexpr bool stable_accumulator(
+    [[maybe_unused]] std::index_sequence<Is...> marker) {
+  return (std::is_same_v<A,
+                         std::decay_t<decltype(std::declval<F&>()(
+                             std::declval<A&&>(),
+                             tuple_get<Is>(std::declval<T>()),
+                             std::declval<Args&>()...))>> &&
+          ...);
+}
+
+template <class T, class A, class F, class... Args, std::size_t... Is>
+A fold_tuple_indexed(T&& tuple,
+                     A acc,
+                     F& fun,
+                     [[maybe_unused]] std::index_sequence<Is...> marker,
+                     Args&... args) {
+  constexpr auto& handlers = indexed_folder<A, F, Args...>::template table<
+      decltype(tuple_get<Is>(std::forward<T>(tuple)))...>;
+  void* const elements[] = {erase_element(tuple_get<Is>(tuple))...};
+  for (std::size_t i = 0; i < sizeof...(Is); ++i) {
+    acc = handlers[i](std::move(acc), elements[i], fun, args...);
+  }
+  return acc;
+}
+
+template <std::size_t S, class T, class A, class F, class... Args>
+constexpr auto fold_tuple_unrolled([[maybe_unused]] T&& tuple,
+                                   A&& acc,
+                                   [[maybe_unused]] F& fun,
+                                   [[maybe_unused]] Args&... args) {
+  if constexpr (S < std::tuple_size_v<
+                        std::remove_cv_t<std::remove_reference_t<T>>>) {
+    return fold_tuple_unrolled<S + 1>(
+        std::forward<T>(tuple),
+        fun(std::forward<A>(acc),
+            tuple_get<S>(std::forward<T>(tuple)),
+            args...),
+        fun,
+        args...);
+  }
+  else {
+    return std::forward<A>(acc);
+  }
+}
+
+template <class Policy, class T, class A, class F, class... Args>
+constexpr auto fold_tuple(T&& tuple, A&& acc, F& fun, Args&... args) {
+  constexpr std::size_t size =
+      std::tuple_size_v<std::remove_cv_t<std::remove_reference_t<T>>>;
+  constexpr auto indices = std::make_index_sequence<size>{};
+  if constexpr (size > Policy::value &&
+                stable_accumulator<T, std::decay_t<A>, F, Args...>(indices)) {
+    if (!constant_evaluation()) {
+      return fold_tuple_indexed(std::forward<T>(tuple),
+                                std::decay_t<A>(std::forward<A>(acc)),
+                                fun,
+                                indices,
+                                args...);
+    }
+  }
+  return fold_tuple_unrolled<0>(
+      std::forward<T>(tuple), std::forward<A>(acc), fun, args...);
+}
+
+}  // namespace detail
+
+template <class Policy, class T>
+struct policy_view {
+  static_assert(is_unroll_policy_v<Policy>,
+                "dpsg::policy_view expects an unroll policy");
+
+  T&& value;
+
+#if defined(__cpp_concepts)
+  template <class F, class... Args>
+  requires(is_fixed_size_array_v<T> || detail::is_tuple_v<T>)
+#else
+  template <
+      class F,
+      class... Args,
+      class U = T,
+      std::enable_if_t<is_fixed_size_array_v<U> || detail::is_tuple_v<U>,
+                       int> = 0>
+#endif
+  constexpr friend void dpsg_traverse(const policy_view& view,
+                                      F&& f,
+                                      Args&&... args) {
+    if constexpr (detail::is_tuple_v<T>) {
+      detail::traverse_tuple<Policy>(std::forward<T>(view.value), f, args...);
+    }
+    else {
+      detail::traverse_array<Policy>(std::forward<T>(view.value), f, args...);
+    }
+  }
+
+#if defined(__cpp_concepts)
+  template <class A, class F, class... Args>
+  requires(is_fixed_size_array_v<T> || detail::is_tuple_v<T>)
+#else
+  template <
+      class A,
+      class F,
+      class... Args,
+      class U = T,
+      std::enable_if_t<is_fixed_size_array_v<U> || detail::is_tuple_v<U>,
+                       int> = 0>
+#endif
+  constexpr friend auto dpsg_fold(const policy_view& view,
+                                  A&& acc,
+                                  F&& fun,
+                                  Args&&... args) {
+    if constexpr (detail::is_tuple_v<T>) {
+      return detail::fold_tuple<Policy>(
+          std::forward<T>(view.value), std::forward<A>(acc), fun, args...);
+    }
+    else {
+      return detail::fold_array<Policy>(
+          std::forward<T>(view.value), std::forward<A>(acc), fun, args...);
+    }
+  }
+};
+
+// The view only holds a reference, it is meant to be consumed in the full
+// expression that created it
+template <class Policy, class T>
+constexpr policy_view<Policy, T> with_policy([[maybe_unused]] Policy policy,
+                                             T&& value) noexcept {
+  return policy_view<Policy, T>{std::forward<T>(value)};
+}
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_UNROLL_HPP
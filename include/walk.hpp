@@ -0,0 +1,276 @@
+#ifndef GUARD_DPSG_WALK_HPP
+#define GUARD_DPSG_WALK_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "./is_template_instance.hpp"
+#include "./traverse.hpp"
+
+/* template<class Node, class... Args> class tree_walker;
+
+    Iterative traversal of recursive runtime data structures (trees of
+   std::variant with std::unique_ptr or std::vector children and the like).
+   Instead of recursing through dpsg_traverse calls, the walker keeps the
+   pending nodes in an explicit stack that is preallocated and reused from one
+   walk to the next, so that deep trees don't overflow the call stack.
+
+    Visitors follow the same protocol as for dpsg::composite: they receive the
+   node, a `next` function and the extra arguments given to the node. Calling
+   next(args...) schedules the children of the node, which will be visited
+   with args... as extra arguments. Not calling it skips the whole subtree.
+
+        struct node {
+          int value;
+          std::vector<std::unique_ptr<node>> children;
+        };
+
+        dpsg::tree_walker<const node, int> walker{1024};
+        walker(dpsg::pre_order, root, [](const node& n, auto next, int depth) {
+          std::cout << std::string(depth, ' ') << n.value << '\n';
+          next(depth + 1);
+        }, 0);
+
+    The argument types of the walker are fixed when it is declared, and every
+   call to next must provide values convertible to them. dpsg::walk deduces
+   them from the arguments given for the root and uses a temporary walker.
+
+    Three orders are supported:
+        - dpsg::pre_order: depth first, the visitor is called before the
+          children are visited.
+        - dpsg::post_order: depth first, the visitor is called after all the
+          children have been visited. This departs from the protocol above:
+          the children are always visited, with the arguments of their
+          parent, so next has no effect. It may still be called without
+          arguments, so that the same visitor can be used in every order,
+          but giving it arguments fails to compile.
+        - dpsg::breadth_first: level by level, left to right.
+
+    The children of a node are found as follows:
+        - If a function dpsg_children(node, push) is found through ADL, it is
+          called and must call push once per child, in order.
+        - If the node is a std::variant, the rules are applied to the active
+          alternative.
+        - If the node has a member named `children`, it is traversed with
+          dpsg::traverse.
+        - Otherwise the node is a leaf.
+    Children may be given to push as references to nodes, or as (smart)
+   pointers to nodes, in which case null pointers are skipped.
+*/
+
+namespace dpsg {
+
+struct pre_order_t {};
+struct post_order_t {};
+struct breadth_first_t {};
+constexpr static inline pre_order_t pre_order{};
+constexpr static inline post_order_t post_order{};
+constexpr static inline breadth_first_t breadth_first{};
+
+namespace detail {
+
+template <std::size_t N>
+struct priority : priority<N - 1> {};
+template <>
+struct priority<0> {};
+
+template <class N, class F>
+constexpr void children_of(N& node, F& push);
+
+template <class N, class F>
+constexpr auto children_of(N& node, F& push, priority<3>)
+    -> decltype(dpsg_children(node, push), void()) {
+  dpsg_children(node, push);
+}
+
+template <class N,
+          class F,
+          std::enable_if_t<
+              is_template_instance_v<std::remove_const_t<N>, std::variant>,
+              int> = 0>
+constexpr void children_of(N& node, F& push, priority<2>) {
+  std::visit([&push](auto& alternative) { children_of(alternative, push); },
+             node);
+}
+
+template <class N, class F>
+constexpr auto children_of(N& node, F& push, priority<1>)
+    -> decltype(node.children, void()) {
+  dpsg::traverse(node.children, push);
+}
+
+template <class N, class F>
+constexpr void children_of([[maybe_unused]] N& node,
+                           [[maybe_unused]] F& push,
+                           priority<0>) {}
+
+template <class N, class F>
+constexpr void children_of(N& node, F& push) {
+  children_of(node, push, priority<3>{});
+}
+
+// In post-order, the children have already been visited with the arguments
+// of their parent when next is given to the visitor
+struct post_order_next {
+  template <class... Args>
+  constexpr void operator()([[maybe_unused]] Args&&... args) const noexcept {
+    static_assert(sizeof...(Args) == 0,
+                  "in post-order, children are visited before their parent, "
+                  "with its arguments: next can't take arguments for them");
+  }
+};
+
+}  // namespace detail
+
+template <class Node, class... Args>
+class tree_walker {
+  struct entry {
+    Node* node;
+    std::tuple<Args...> args;
+    bool expanded;
+  };
+
+  template <class Order>
+  struct next_t {
+    tree_walker* walker;
+    Node* node;
+
+    template <class... Args2>
+    void operator()(Args2&&... args) const {
+      walker->template schedule_children<Order>(
+          *node, Args(std::forward<Args2>(args))...);
+    }
+  };
+
+ public:
+  explicit tree_walker(std::size_t capacity = 64) {
+    entries_.reserve(capacity);
+  }
+
+  // Number of pending nodes the walker can hold without allocating
+  [[nodiscard]] std::size_t capacity() const noexcept {
+    return entries_.capacity();
+  }
+
+  template <class F, class... Args2>
+  void operator()(pre_order_t, Node& root, F&& visitor, Args2&&... args) {
+    clear();
+    entries_.push_back(entry{std::addressof(root),
+                             std::tuple<Args...>(std::forward<Args2>(args)...),
+                             false});
+    while (!entries_.empty()) {
+      entry current = std::move(entries_.back());
+      entries_.pop_back();
+      visit(current, visitor, next_t<pre_order_t>{this, current.node});
+    }
+  }
+
+  template <class F, class... Args2>
+  void operator()(post_order_t, Node& root, F&& visitor, Args2&&... args) {
+    clear();
+    entries_.push_back(entry{std::addressof(root),
+                             std::tuple<Args...>(std::forward<Args2>(args)...),
+                             false});
+    while (!entries_.empty()) {
+      entry& top = entries_.back();
+      if (top.expanded) {
+        entry current = std::move(top);
+        entries_.pop_back();
+        visit(current, visitor, detail::post_order_next{});
+      }
+      else {
+        top.expanded = true;
+        Node& node = *top.node;
+        // Copied since scheduling the children may reallocate the stack
+        std::tuple<Args...> args_copy = top.args;
+        std::apply(
+            [this, &node](auto&&... a) {
+              schedule_children<post_order_t>(node, std::move(a)...);
+            },
+            std::move(args_copy));
+      }
+    }
+  }
+
+  template <class F, class... Args2>
+  void operator()(breadth_first_t, Node& root, F&& visitor, Args2&&... args) {
+    clear();
+    entries_.push_back(entry{std::addressof(root),
+                             std::tuple<Args...>(std::forward<Args2>(args)...),
+                             false});
+    while (head_ < entries_.size()) {
+      entry current = std::move(entries_[head_++]);
+      // Reclaims the space of the visited entries once they make up half of
+      // the queue, so that memory stays proportional to the widest level
+      if (head_ == entries_.size()) {
+        clear();
+      }
+      else if (head_ * 2 >= entries_.size() && head_ >= 32) {
+        entries_.erase(entries_.begin(),
+                       entries_.begin() + static_cast<std::ptrdiff_t>(head_));
+        head_ = 0;
+      }
+      visit(current, visitor, next_t<breadth_first_t>{this, current.node});
+    }
+    clear();
+  }
+
+ private:
+  template <class F, class N>
+  static void visit(entry& current, F& visitor, N next) {
+    std::apply(
+        [&current, &visitor, &next](auto&... args) {
+          visitor(*current.node, next, args...);
+        },
+        current.args);
+  }
+
+  template <class Order>
+  void schedule_children(Node& node, Args... args) {
+    const std::size_t first = entries_.size();
+    auto push = [this, &args...](auto&& child) {
+      using child_t = std::remove_reference_t<decltype(child)>;
+      if constexpr (std::is_convertible_v<child_t*, Node*>) {
+        entries_.push_back(entry{std::addressof(child), {args...}, false});
+      }
+      else if (child) {
+        entries_.push_back(entry{std::addressof(*child), {args...}, false});
+      }
+    };
+    detail::children_of(node, push);
+    if constexpr (!std::is_same_v<Order, breadth_first_t>) {
+      // The first child must end up on top of the stack
+      std::reverse(entries_.begin() + static_cast<std::ptrdiff_t>(first),
+                   entries_.end());
+    }
+  }
+
+  void clear() noexcept {
+    entries_.clear();
+    head_ = 0;
+  }
+
+  std::vector<entry> entries_;
+  std::size_t head_{0};
+};
+
+namespace detail {
+struct walk_t {
+  template <class Order, class Node, class F, class... Args>
+  void operator()(Order order, Node& root, F&& visitor, Args&&... args) const {
+    tree_walker<Node, std::decay_t<Args>...> walker;
+    walker(order, root, std::forward<F>(visitor), std::forward<Args>(args)...);
+  }
+};
+}  // namespace detail
+constexpr static inline detail::walk_t walk{};
+
+}  // namespace dpsg
+
+#endif  // GUARD_DPSG_WALK_HPP
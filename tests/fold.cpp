@@ -0,0 +1,155 @@
+#include <compressed_tuple.hpp>
+#include <fold.hpp>
+#include <pipeline.hpp>
+#include <unroll.hpp>
+
+#include "./tracking.hpp"
+
+#include <array>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// dpsg::fold must move the accumulator from one step to the next, never copy
+// it, and hand the elements and the extra arguments to the folding function
+// without copying them or allocating, whatever the customization point.
+
+using tracking::counts;
+using tracking::tracked;
+
+namespace {
+
+// Moves the accumulator through, reads the elements and the extra arguments
+struct accumulate {
+  tracked operator()(tracked&& acc, const tracked& element) const {
+    acc.add(element.value());
+    return std::move(acc);
+  }
+  tracked operator()(tracked&& acc,
+                     const tracked& element,
+                     const tracked& extra) const {
+    acc.add(element.value() + extra.value());
+    return std::move(acc);
+  }
+};
+
+// Takes everything by value: the initial accumulator is copied if it is an
+// lvalue, and the extra argument for every element
+struct by_value {
+  tracked operator()(tracked acc, tracked element, tracked extra) const {
+    acc.add(element.value() + extra.value());
+    return acc;
+  }
+};
+
+// The number of copies and allocations, and the stale uses, are exact. The
+// number of moves of the accumulator is up to the compiler
+void check_no_copies(const counts& c, const char* what, int line) {
+  tracking::check_counts(
+      counts{c.allocations, c.copies, 0, c.stale_uses}, counts{}, what, line);
+}
+
+#define CHECK_NO_COPIES(what, ...) \
+  check_no_copies(::tracking::measure([&] { __VA_ARGS__; }), what, __LINE__)
+
+}  // namespace
+
+int main() {
+  int sum = 0;
+  const tracked extra{100};
+  const auto keep = [&sum](const tracked& result) { sum += result.value(); };
+
+  std::tuple<tracked, tracked, tracked> tuple{tracked{1}, tracked{2},
+                                              tracked{3}};
+  CHECK_NO_COPIES("tuple",
+                  keep(dpsg::fold(tuple, tracked{0}, accumulate{})));
+  CHECK_NO_COPIES("tuple, extra argument",
+                  keep(dpsg::fold(tuple, tracked{0}, accumulate{}, extra)));
+  CHECK_NO_COPIES(
+      "tuple, indexed dispatch",
+      keep(dpsg::fold(dpsg::with_policy(dpsg::never_unroll, tuple),
+                      tracked{0},
+                      accumulate{},
+                      extra)));
+
+  // Copies are made where the caller asks for them, and only there
+  tracked initial{0};
+  const counts by_value_tuple = tracking::measure([&] {
+    keep(dpsg::fold(tuple, initial, by_value{}, tracked{100}));
+  });
+  CHECK(by_value_tuple.copies == 1 + 2 * 3);
+  CHECK(by_value_tuple.stale_uses == 0 && initial.value() == 0);
+
+  std::pair<tracked, tracked> pair{tracked{1}, tracked{2}};
+  CHECK_NO_COPIES("pair",
+                  keep(dpsg::fold(pair, tracked{0}, accumulate{}, extra)));
+
+  std::optional<tracked> optional{tracked{1}};
+  CHECK_NO_COPIES("optional",
+                  keep(dpsg::fold(optional, tracked{0}, accumulate{}, extra)));
+  optional.reset();
+  CHECK_NO_COPIES("empty optional",
+                  keep(dpsg::fold(optional, tracked{0}, accumulate{}, extra)));
+
+  std::variant<tracked, int> variant{tracked{1}};
+  CHECK_NO_COPIES(
+      "variant",
+      keep(dpsg::fold(variant,
+                      tracked{0},
+                      [](tracked&& acc, const auto& v, const tracked& e) {
+                        if constexpr (std::is_same_v<std::decay_t<decltype(v)>,
+                                                     tracked>) {
+                          acc.add(v.value() + e.value());
+                        }
+                        return std::move(acc);
+                      },
+                      extra)));
+
+  tracked c_array[3] = {tracked{1}, tracked{2}, tracked{3}};
+  CHECK_NO_COPIES("C array",
+                  keep(dpsg::fold(c_array, tracked{0}, accumulate{}, extra)));
+  std::array<tracked, 3> small_array{tracked{1}, tracked{2}, tracked{3}};
+  CHECK_NO_COPIES(
+      "std::array, unrolled",
+      keep(dpsg::fold(small_array, tracked{0}, accumulate{}, extra)));
+  std::array<tracked, 64> large_array{};
+  CHECK_NO_COPIES(
+      "std::array, loop",
+      keep(dpsg::fold(large_array, tracked{0}, accumulate{}, extra)));
+
+  using vector_allocator = tracking::counting_allocator<tracked>;
+  std::vector<tracked, vector_allocator> vector(100);
+  const std::size_t vector_allocations = vector_allocator::allocations;
+  CHECK(vector_allocations > 0);
+  CHECK_NO_COPIES("vector",
+                  keep(dpsg::fold(vector, tracked{0}, accumulate{}, extra)));
+  const counts by_value_vector = tracking::measure([&] {
+    keep(dpsg::fold(vector, initial, by_value{}, tracked{100}));
+  });
+  CHECK(by_value_vector.copies == 1 + 2 * 100);
+  CHECK(by_value_vector.stale_uses == 0);
+  // The allocator of the container isn't used either, its counter is apart
+  // from the totals
+  CHECK(vector_allocator::allocations == vector_allocations);
+
+  dpsg::compressed_tuple<tracked, tracked> compressed{tracked{1}, tracked{2}};
+  CHECK_NO_COPIES(
+      "compressed tuple",
+      keep(dpsg::fold(compressed, tracked{0}, accumulate{}, extra)));
+
+  CHECK_NO_COPIES(
+      "pipeline",
+      keep(dpsg::fold(vector | dpsg::filter([](const tracked& t) {
+                        return t.value() >= 0;
+                      }),
+                      tracked{0},
+                      accumulate{},
+                      extra)));
+
+  std::cout << (tracking::failures == 0 ? "all checks passed"
+                                        : "some checks failed")
+            << " (" << sum << ")\n";
+  return tracking::failures == 0 ? 0 : 1;
+}
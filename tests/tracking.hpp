@@ -0,0 +1,160 @@
+#ifndef GUARD_DPSG_TESTS_TRACKING_HPP
+#define GUARD_DPSG_TESTS_TRACKING_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <utility>
+
+// Instrumentation for the tests: global allocation counting, an allocator
+// counting what goes through it, and an element type counting its copies and
+// moves. Each test is a single translation unit including this header once,
+// since it replaces the global operator new and operator delete.
+
+namespace tracking {
+
+struct counts {
+  std::size_t allocations{0};
+  std::size_t copies{0};
+  std::size_t moves{0};
+  // Uses of an object after it was moved from
+  std::size_t stale_uses{0};
+
+  friend bool operator==(const counts& l, const counts& r) noexcept {
+    return l.allocations == r.allocations && l.copies == r.copies &&
+           l.moves == r.moves && l.stale_uses == r.stale_uses;
+  }
+  friend counts operator-(const counts& l, const counts& r) noexcept {
+    return counts{l.allocations - r.allocations,
+                  l.copies - r.copies,
+                  l.moves - r.moves,
+                  l.stale_uses - r.stale_uses};
+  }
+  friend std::ostream& operator<<(std::ostream& out, const counts& c) {
+    return out << "{" << c.allocations << " allocations, " << c.copies
+               << " copies, " << c.moves << " moves, " << c.stale_uses
+               << " stale uses}";
+  }
+};
+
+inline counts total;
+
+// Counts what happens while f runs
+template <class F>
+counts measure(F&& f) {
+  const counts before = total;
+  std::forward<F>(f)();
+  return total - before;
+}
+
+// Element counting its copies and moves. Moved-from objects are marked, and
+// reading the value of one is counted as a stale use
+class tracked {
+ public:
+  constexpr static int moved_from = -1;
+
+  tracked() noexcept = default;
+  explicit tracked(int value) noexcept : value_{value} {}
+  tracked(const tracked& other) noexcept : value_{other.value_} {
+    ++total.copies;
+  }
+  tracked(tracked&& other) noexcept
+      : value_{std::exchange(other.value_, moved_from)} {
+    ++total.moves;
+  }
+  tracked& operator=(const tracked& other) noexcept {
+    value_ = other.value_;
+    ++total.copies;
+    return *this;
+  }
+  tracked& operator=(tracked&& other) noexcept {
+    value_ = std::exchange(other.value_, moved_from);
+    ++total.moves;
+    return *this;
+  }
+  ~tracked() = default;
+
+  [[nodiscard]] int value() const noexcept {
+    if (value_ == moved_from) {
+      ++total.stale_uses;
+    }
+    return value_;
+  }
+  void add(int i) noexcept { value_ += i; }
+
+ private:
+  int value_{0};
+};
+
+// Allocator counting its allocations apart from the totals, so that the
+// containers of a test can be set up anywhere without skewing them
+template <class T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() noexcept = default;
+  template <class U>
+  explicit counting_allocator(const counting_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    ++allocations;
+    if (void* p = std::malloc(n * sizeof(T))) {
+      return static_cast<T*>(p);
+    }
+    throw std::bad_alloc{};
+  }
+  void deallocate(T* p, [[maybe_unused]] std::size_t n) noexcept {
+    std::free(p);
+  }
+
+  friend bool operator==(const counting_allocator&,
+                         const counting_allocator&) noexcept {
+    return true;
+  }
+  friend bool operator!=(const counting_allocator&,
+                         const counting_allocator&) noexcept {
+    return false;
+  }
+
+  static inline std::size_t allocations = 0;
+};
+
+inline int failures = 0;
+
+inline void check(bool condition, const char* expression, int line) {
+  if (!condition) {
+    std::cerr << "line " << line << ": check failed: " << expression << "\n";
+    ++failures;
+  }
+}
+
+inline void check_counts(const counts& actual,
+                         const counts& expected,
+                         const char* what,
+                         int line) {
+  if (!(actual == expected)) {
+    std::cerr << "line " << line << ": " << what << ": expected " << expected
+              << ", got " << actual << "\n";
+    ++failures;
+  }
+}
+
+}  // namespace tracking
+
+#define CHECK(...) ::tracking::check((__VA_ARGS__), #__VA_ARGS__, __LINE__)
+#define CHECK_COUNTS(what, expected, ...)                                 \
+  ::tracking::check_counts(                                               \
+      ::tracking::measure([&] { __VA_ARGS__; }), expected, what, __LINE__)
+
+void* operator new(std::size_t size) {
+  ++tracking::total.allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+#endif  // GUARD_DPSG_TESTS_TRACKING_HPP
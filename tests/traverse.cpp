@@ -0,0 +1,177 @@
+#include <composite.hpp>
+#include <compressed_tuple.hpp>
+#include <pipeline.hpp>
+#include <traverse.hpp>
+#include <unroll.hpp>
+
+#include "./tracking.hpp"
+
+#include <array>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// dpsg::traverse must hand the elements, and the extra arguments, to the
+// visitor without copying them or allocating, whatever the customization
+// point.
+
+using tracking::counts;
+using tracking::tracked;
+
+namespace {
+
+// Reads everything it receives, so that moved-from objects are noticed
+struct reader {
+  int* sum;
+  void operator()(const tracked& t) const { *sum += t.value(); }
+  void operator()(const tracked& t, const tracked& extra) const {
+    *sum += t.value() + extra.value();
+  }
+};
+
+// Takes the extra argument by value: it must be copied for every element,
+// never moved from
+struct copies_extra {
+  int* sum;
+  void operator()(const tracked& t, tracked extra) const {
+    *sum += t.value() + extra.value();
+  }
+};
+
+template <class... Args>
+struct node : dpsg::composite<Args...> {
+  template <class... Args2>
+  explicit node(int value, Args2&&... args)
+      : dpsg::composite<Args...>{std::forward<Args2>(args)...}, value{value} {}
+  tracked value;
+};
+template <class... Args>
+node(int, Args&&...) -> node<Args...>;
+
+}  // namespace
+
+int main() {
+  const counts nothing{};
+  int sum = 0;
+  const tracked extra{100};
+
+  std::tuple<tracked, tracked, tracked> tuple{tracked{1}, tracked{2},
+                                              tracked{3}};
+  CHECK_COUNTS("tuple", nothing, dpsg::traverse(tuple, reader{&sum}));
+  CHECK_COUNTS("tuple, extra argument",
+               nothing,
+               dpsg::traverse(tuple, reader{&sum}, extra));
+  CHECK_COUNTS("tuple, rvalue extra argument",
+               (counts{0, 3, 0, 0}),
+               dpsg::traverse(tuple, copies_extra{&sum}, tracked{100}));
+  CHECK_COUNTS("tuple, indexed dispatch",
+               nothing,
+               dpsg::traverse(dpsg::with_policy(dpsg::never_unroll, tuple),
+                              reader{&sum},
+                              extra));
+  CHECK_COUNTS("rvalue tuple, elements moved to the visitor",
+               (counts{0, 0, 3, 0}),
+               dpsg::traverse(std::move(tuple), [&sum](tracked t) {
+                 sum += t.value();
+               }));
+
+  std::pair<tracked, tracked> pair{tracked{1}, tracked{2}};
+  CHECK_COUNTS("pair", nothing, dpsg::traverse(pair, reader{&sum}, extra));
+  CHECK_COUNTS("pair, rvalue extra argument",
+               (counts{0, 2, 0, 0}),
+               dpsg::traverse(pair, copies_extra{&sum}, tracked{100}));
+
+  std::optional<tracked> optional{tracked{1}};
+  CHECK_COUNTS(
+      "optional", nothing, dpsg::traverse(optional, reader{&sum}, extra));
+
+  std::variant<tracked, int> variant{tracked{1}};
+  CHECK_COUNTS("variant",
+               nothing,
+               dpsg::traverse(variant,
+                              [&sum](const auto& v, const tracked& e) {
+                                if constexpr (std::is_same_v<
+                                                  std::decay_t<decltype(v)>,
+                                                  tracked>) {
+                                  sum += v.value() + e.value();
+                                }
+                              },
+                              extra));
+
+  tracked c_array[3] = {tracked{1}, tracked{2}, tracked{3}};
+  CHECK_COUNTS(
+      "C array", nothing, dpsg::traverse(c_array, reader{&sum}, extra));
+  std::array<tracked, 3> small_array{tracked{1}, tracked{2}, tracked{3}};
+  CHECK_COUNTS("std::array, unrolled",
+               nothing,
+               dpsg::traverse(small_array, reader{&sum}, extra));
+  std::array<tracked, 64> large_array{};
+  CHECK_COUNTS("std::array, loop",
+               nothing,
+               dpsg::traverse(large_array, reader{&sum}, extra));
+  CHECK_COUNTS("std::array, rvalue extra argument",
+               (counts{0, 64, 0, 0}),
+               dpsg::traverse(large_array, copies_extra{&sum}, tracked{100}));
+
+  using vector_allocator = tracking::counting_allocator<tracked>;
+  std::vector<tracked, vector_allocator> vector(100);
+  const std::size_t vector_allocations = vector_allocator::allocations;
+  CHECK(vector_allocations > 0);
+  CHECK_COUNTS("vector", nothing, dpsg::traverse(vector, reader{&sum}, extra));
+  CHECK_COUNTS("vector, rvalue extra argument",
+               (counts{0, 100, 0, 0}),
+               dpsg::traverse(vector, copies_extra{&sum}, tracked{100}));
+  // The allocator of the container isn't used either, its counter is apart
+  // from the totals
+  CHECK(vector_allocator::allocations == vector_allocations);
+
+  dpsg::compressed_tuple<tracked, char, tracked> compressed{
+      tracked{1}, 'a', tracked{2}};
+  CHECK_COUNTS("compressed tuple",
+               nothing,
+               dpsg::traverse(compressed, [&sum](const auto& e) {
+                 if constexpr (std::is_same_v<std::decay_t<decltype(e)>,
+                                              tracked>) {
+                   sum += e.value();
+                 }
+               }));
+
+  CHECK_COUNTS("pipeline",
+               nothing,
+               dpsg::traverse(vector | dpsg::filter([](const tracked& t) {
+                                return t.value() >= 0;
+                              }) | dpsg::transform([](const tracked& t)
+                                                       -> const tracked& {
+                                return t;
+                              }),
+                              reader{&sum},
+                              extra));
+
+  // Arguments given to next() reach every component, and none is moved from
+  const node tree{1, node{2}, node{3, node{4}}, node{5}};
+  CHECK_COUNTS("composite, arguments given to next",
+               nothing,
+               dpsg::traverse(tree,
+                              [&sum](const auto& n, auto next,
+                                     const tracked& depth) {
+                                sum += n.value.value() + depth.value();
+                                next(tracked{depth.value() + 1});
+                              },
+                              tracked{0}));
+  // Taken by value, they are copied for every component
+  CHECK_COUNTS("composite, arguments taken by value",
+               (counts{0, 4, 1, 0}),
+               dpsg::traverse(tree,
+                              [&sum](const auto& n, auto next, tracked depth) {
+                                sum += n.value.value() + depth.value();
+                                next(tracked{depth.value() + 1});
+                              },
+                              tracked{0}));
+
+  std::cout << (tracking::failures == 0 ? "all checks passed"
+                                        : "some checks failed")
+            << " (" << sum << ")\n";
+  return tracking::failures == 0 ? 0 : 1;
+}